@@ -0,0 +1,53 @@
+// Helpers shared by the Linux benchmarks.
+#ifndef BENCHLEVEL_H
+#define BENCHLEVEL_H
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <string>
+
+// a level shaped like ours: mostly air, a floor, scattered platforms and spikes
+inline void WriteBenchLevel(const std::string& fileName, int width, int height) {
+	std::ofstream out(fileName);
+	out << "[header]\nwidth=" << width << "\nheight=" << height << "\ntilewidth=16\ntileheight=16\n\n";
+	out << "[layer]\ntype=Tile Layer 1\ndata=\n";
+	unsigned int seed = 12345;
+	for (int y = 0; y < height; y++) {
+		std::string row;
+		for (int x = 0; x < width; x++) {
+			seed = seed * 1103515245u + 12345u;
+			int tile = 0;
+			if (y >= height - 2) {
+				tile = 34;
+			}
+			else if ((seed >> 16) % 7 == 0) {
+				tile = (int)((seed >> 8) % 128) + 1;
+			}
+			row += std::to_string(tile);
+			if (x + 1 < width || y + 1 < height) {
+				row += ',';
+			}
+		}
+		out << row << "\n";
+	}
+	out << "\n";
+	for (int i = 0; i < width / 20; i++) {
+		out << "[ObjectsLayer]\n# Annoying\ntype=Annoying\nlocation=" << i * 20 << "," << height - 3 << ",1,1\n\n";
+	}
+}
+
+// fastest of several runs, in seconds
+template <typename F>
+double BestOf(int runs, F run) {
+	double best = 1e30;
+	for (int i = 0; i < runs; i++) {
+		auto start = std::chrono::steady_clock::now();
+		run();
+		std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+		best = std::min(best, time.count());
+	}
+	return best;
+}
+
+#endif
@@ -0,0 +1,180 @@
+// Times SweepAndPrune against testing every pair, for a crowd of boxes
+// wandering along a level shaped strip: once with every box colliding with
+// every other, and once the way the game uses it, with a player and a full
+// set of barriers against the rest. Checks both find the same pairs.
+//
+// usage: broadbench [entities] [steps]
+
+#include "benchlevel.h"
+#include "SweepAndPrune.h"
+#include "helper.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+// beyond this many boxes testing every pair takes seconds a step
+static const int MAX_BRUTE_FORCE = 20000;
+
+static const int QUERIES = 9;
+
+struct Crowd {
+	std::vector<float> x;
+	std::vector<float> y;
+	std::vector<float> velX;
+	float right;
+
+	void Move() {
+		for (size_t i = 0; i < x.size(); i++) {
+			x[i] += velX[i] * FIXED_TIMESTEP;
+			if (x[i] < 0.0f || x[i] > right) {
+				velX[i] = -velX[i];
+			}
+		}
+	}
+};
+
+// the same padded boxes SweepAndPrune builds
+static bool Overlaps(const Crowd& crowd, int a, int b) {
+	float half = TILE_SIZE * 0.5f + SweepAndPrune::MARGIN;
+	return crowd.x[a] - half <= crowd.x[b] + half && crowd.x[b] - half <= crowd.x[a] + half &&
+		crowd.y[a] - half <= crowd.y[b] + half && crowd.y[b] - half <= crowd.y[a] + half;
+}
+
+static void Normalize(std::vector<OverlapPair>& pairs) {
+	for (OverlapPair& pair : pairs) {
+		if (pair.first > pair.second) {
+			std::swap(pair.first, pair.second);
+		}
+	}
+	std::sort(pairs.begin(), pairs.end(), [](const OverlapPair& a, const OverlapPair& b) {
+		return a.first != b.first ? a.first < b.first : a.second < b.second;
+	});
+}
+
+static bool SamePairs(std::vector<OverlapPair> a, std::vector<OverlapPair> b) {
+	Normalize(a);
+	Normalize(b);
+	if (a.size() != b.size()) {
+		return false;
+	}
+	for (size_t i = 0; i < a.size(); i++) {
+		if (a[i].first != b[i].first || a[i].second != b[i].second) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// every pair among all the boxes, or the queries (the first QUERIES boxes)
+// against the rest
+static void BruteForce(const Crowd& crowd, bool queriesOnly, std::vector<OverlapPair>& out) {
+	int count = (int)crowd.x.size();
+	for (int a = 0; a < (queriesOnly ? QUERIES : count); a++) {
+		for (int b = queriesOnly ? QUERIES : a + 1; b < count; b++) {
+			if (Overlaps(crowd, a, b)) {
+				OverlapPair pair;
+				pair.first = a;
+				pair.second = b;
+				out.push_back(pair);
+			}
+		}
+	}
+}
+
+static void Sweep(SweepAndPrune& broadphase, const Crowd& crowd, std::vector<OverlapPair>& out) {
+	for (int i = 0; i < broadphase.Count(); i++) {
+		broadphase.Set(i, crowd.x[i], crowd.y[i], TILE_SIZE, TILE_SIZE);
+	}
+	broadphase.FindPairs(out);
+	for (OverlapPair& pair : out) {
+		pair.first = broadphase.Id(pair.first);
+		pair.second = broadphase.Id(pair.second);
+	}
+}
+
+static void Run(const Crowd& start, bool queriesOnly, int steps) {
+	int count = (int)start.x.size();
+	bool brute = queriesOnly || count <= MAX_BRUTE_FORCE;
+
+	std::vector<OverlapPair> brutePairs;
+	double bruteTime = 0.0;
+	if (brute) {
+		bruteTime = BestOf(3, [&]() {
+			Crowd crowd = start;
+			for (int s = 0; s < steps; s++) {
+				crowd.Move();
+				brutePairs.clear();
+				BruteForce(crowd, queriesOnly, brutePairs);
+			}
+		});
+	}
+
+	std::vector<OverlapPair> sweepPairs;
+	long long swaps = 0;
+	double sweepTime = BestOf(3, [&]() {
+		Crowd crowd = start;
+		SweepAndPrune broadphase;
+		for (int i = 0; i < count; i++) {
+			broadphase.Add(queriesOnly && i < QUERIES ? 0 : 1, i);
+		}
+		broadphase.SetCollides(queriesOnly ? 0 : 1, 1, true);
+		swaps = 0;
+		for (int s = 0; s < steps; s++) {
+			crowd.Move();
+			sweepPairs.clear();
+			Sweep(broadphase, crowd, sweepPairs);
+			swaps += broadphase.LastSwaps();
+		}
+	});
+
+	printf("%s\n", queriesOnly ? "player and barriers against the rest:" : "every box against every other:");
+	if (brute) {
+		printf("  every pair:      %9.3f ms/step\n", bruteTime * 1000.0 / steps);
+	}
+	else {
+		printf("  every pair:      skipped, over %d boxes\n", MAX_BRUTE_FORCE);
+	}
+	printf("  sweep and prune: %9.3f ms/step", sweepTime * 1000.0 / steps);
+	if (brute) {
+		printf(", %.1fx", bruteTime / sweepTime);
+	}
+	printf("\n  %d pairs, %lld swaps/step", (int)sweepPairs.size(), swaps / steps);
+	if (brute) {
+		printf(", %s", SamePairs(brutePairs, sweepPairs) ? "same pairs, ok" : "pairs differ, WRONG");
+	}
+	printf("\n");
+}
+
+int main(int argc, char *argv[])
+{
+	int count = argc > 1 ? std::atoi(argv[1]) : 100000;
+	int steps = argc > 2 ? std::atoi(argv[2]) : 60;
+
+	// spread over a 2000 x 60 tile level walking left and right at enemy
+	// speed; the first QUERIES stand in for the player and barriers and sit
+	// together in the middle
+	int width = 2000;
+	int height = 60;
+	Crowd start;
+	start.right = width * TILE_SIZE;
+	unsigned int seed = 2024;
+	for (int i = 0; i < count; i++) {
+		seed = seed * 1103515245u + 12345u;
+		float x = (float)((seed >> 8) % (unsigned int)(width * 16)) / 16.0f * TILE_SIZE;
+		seed = seed * 1103515245u + 12345u;
+		float y = (float)((seed >> 8) % (unsigned int)(height * 16)) / 16.0f * TILE_SIZE;
+		if (i < QUERIES) {
+			x = start.right * 0.5f + i * TILE_SIZE * 0.5f;
+			y = height * TILE_SIZE * 0.5f;
+		}
+		start.x.push_back(x);
+		start.y.push_back(y);
+		start.velX.push_back((seed >> 4) & 1 ? 0.35f : -0.35f);
+	}
+
+	printf("%d boxes, %d steps\n", count, steps);
+	Run(start, false, steps);
+	Run(start, true, steps);
+	return 0;
+}
@@ -0,0 +1,197 @@
+// Steps a crowd of chasing enemies over a large level, one Entity at a time
+// the way Simulation used to, and as the SIMD Enemies arrays, and checks both
+// end up bit for bit in the same place. Then times the arrays again letting
+// enemies that are left behind go back to sleep, a level where every enemy
+// is still asleep and only the few near the target wake, and every enemy
+// awake with and without the level of detail.
+//
+// usage: enemybench [enemies] [steps]
+
+#include "benchlevel.h"
+#include "Enemies.h"
+#include "Entity.h"
+#include "FlareMap.h"
+#include "helper.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// the enemy loop of Simulation::UpdateLevel before Enemies
+static void StepEntities(std::vector<Entity>& enemies, float targetX, FlareMap& map) {
+	for (Entity& i : enemies) {
+		if (i.isStatic) {
+			if (fabs(i.x - targetX) < TILE_SIZE) {
+				i.isStatic = false;
+			}
+		}
+		else {
+			float diff = i.x - targetX;
+			i.velX = diff < 0 ? 0.35f : -0.35f;
+			i.Update(FIXED_TIMESTEP, &map);
+		}
+	}
+}
+
+static int AwakeCount(const Enemies& enemies) {
+	int awake = 0;
+	enemies.ForEachAwake([&](int) { awake++; });
+	return awake;
+}
+
+static bool Same(float a, float b) {
+	return memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+// the target sweeps back and forth across the level so enemies turn around
+static float TargetX(int step, int width) {
+	int period = 600;
+	float t = (float)(step % period) / (float)period;
+	return (t < 0.5f ? t * 2.0f : 2.0f - t * 2.0f) * width * TILE_SIZE;
+}
+
+int main(int argc, char *argv[])
+{
+	int count = argc > 1 ? std::atoi(argv[1]) : 100000;
+	int steps = argc > 2 ? std::atoi(argv[2]) : 60;
+
+	int width = 2000;
+	int height = 60;
+	std::string fileName = "enemybench.txt";
+	WriteBenchLevel(fileName, width, height);
+	FlareMap map(TILE_SIZE);
+	if (!map.Load(fileName)) {
+		printf("%s\n", map.loadError.c_str());
+		return 1;
+	}
+
+	// most awake and spread over the level, some asleep, some knocked out
+	// below it like the barrier does
+	std::vector<Entity> start;
+	Enemies startArrays;
+	startArrays.Reserve(count);
+	// the old loop never puts an enemy back to sleep, and steps everyone
+	startArrays.sleepWhenLeftBehind = false;
+	startArrays.levelOfDetail = false;
+	Enemies dormant;
+	dormant.Reserve(count);
+	unsigned int seed = 2024;
+	for (int i = 0; i < count; i++) {
+		seed = seed * 1103515245u + 12345u;
+		float x = (float)((seed >> 8) % (unsigned int)(width * 16)) / 16.0f * TILE_SIZE;
+		seed = seed * 1103515245u + 12345u;
+		float y = -(float)((seed >> 8) % (unsigned int)((height - 3) * 16)) / 16.0f * TILE_SIZE;
+		int kind = (int)((seed >> 4) % 20);
+		if (kind == 0) {
+			y -= 1000.0f;
+		}
+		Entity entity(x, y, TILE_SIZE, TILE_SIZE, kind == 1);
+		start.push_back(entity);
+		int index = startArrays.Add(x, y, TILE_SIZE, TILE_SIZE);
+		if (kind != 1) {
+			startArrays.Wake(index);
+		}
+		dormant.Add(x, y, TILE_SIZE, TILE_SIZE);
+	}
+
+	std::vector<Entity> entities;
+	double entityTime = BestOf(3, [&]() {
+		entities = start;
+		for (int s = 0; s < steps; s++) {
+			StepEntities(entities, TargetX(s, width), map);
+		}
+	});
+
+	Enemies arrays;
+	double arrayTime = BestOf(3, [&]() {
+		arrays = startArrays;
+		for (int s = 0; s < steps; s++) {
+			arrays.Step(FIXED_TIMESTEP, TargetX(s, width), map);
+		}
+	});
+
+	int mismatches = 0;
+	for (int i = 0; i < count; i++) {
+		const Entity& e = entities[i];
+		if (!Same(e.x, arrays.x[i]) || !Same(e.y, arrays.y[i]) || !Same(e.prevX, arrays.prevX[i]) ||
+			!Same(e.prevY, arrays.prevY[i]) || !Same(e.velX, arrays.velX[i]) || !Same(e.velY, arrays.velY[i]) ||
+			e.isStatic == arrays.Awake(i)) {
+			if (mismatches++ < 5) {
+				printf("enemy %d: entity %g,%g arrays %g,%g\n", i, e.x, e.y, arrays.x[i], arrays.y[i]);
+			}
+		}
+	}
+
+	printf("%d enemies, %d steps, %s kernel (%d lanes)\n", count, steps, Enemies::KernelName(), Enemies::LANES);
+	printf("entities: %8.3f ms/step\n", entityTime * 1000.0 / steps);
+	printf("arrays:   %8.3f ms/step, %.1fx\n", arrayTime * 1000.0 / steps, entityTime / arrayTime);
+	printf("%d enemies differ, %s\n", mismatches, mismatches == 0 ? "ok" : "WRONG");
+
+	// the target at the end of the level leaves almost everyone behind
+	Enemies sleeping;
+	double sleepingTime = BestOf(3, [&]() {
+		sleeping = startArrays;
+		sleeping.sleepWhenLeftBehind = true;
+		for (int s = 0; s < steps; s++) {
+			sleeping.Step(FIXED_TIMESTEP, width * TILE_SIZE, map);
+		}
+	});
+	printf("left behind sleep: %8.3f ms/step, %d awake after\n", sleepingTime * 1000.0 / steps, AwakeCount(sleeping));
+
+	// a target walking through a level nobody has woken yet
+	std::vector<Entity> asleep;
+	double asleepEntityTime = BestOf(3, [&]() {
+		asleep = start;
+		for (Entity& e : asleep) {
+			e.isStatic = true;
+		}
+		for (int s = 0; s < steps; s++) {
+			StepEntities(asleep, s * TILE_SIZE * 0.1f, map);
+		}
+	});
+	Enemies asleepArrays;
+	double asleepArrayTime = BestOf(3, [&]() {
+		asleepArrays = dormant;
+		for (int s = 0; s < steps; s++) {
+			asleepArrays.Step(FIXED_TIMESTEP, s * TILE_SIZE * 0.1f, map);
+		}
+	});
+	printf("all asleep: entities %8.3f ms/step, arrays %8.3f ms/step, %d awake after\n",
+		asleepEntityTime * 1000.0 / steps, asleepArrayTime * 1000.0 / steps, AwakeCount(asleepArrays));
+
+	// a target walking from the middle of the level, everyone stepped in
+	// full and with the level of detail
+	float middle = width * TILE_SIZE * 0.5f;
+	Enemies full;
+	double fullTime = BestOf(3, [&]() {
+		full = startArrays;
+		for (int s = 0; s < steps; s++) {
+			full.Step(FIXED_TIMESTEP, middle + s * TILE_SIZE * 0.1f, map);
+		}
+	});
+	Enemies detail;
+	double detailTime = BestOf(3, [&]() {
+		detail = startArrays;
+		detail.levelOfDetail = true;
+		for (int s = 0; s < steps; s++) {
+			detail.Step(FIXED_TIMESTEP, middle + s * TILE_SIZE * 0.1f, map);
+		}
+	});
+	// anything the camera could show has to match
+	float lastTarget = middle + (steps - 1) * TILE_SIZE * 0.1f;
+	int visible = 0;
+	int visibleDiffer = 0;
+	for (int i = 0; i < count; i++) {
+		if (fabs(full.x[i] - lastTarget) < VIEW_HALF_WIDTH * 2.0f) {
+			visible++;
+			if (!Same(full.x[i], detail.x[i]) || !Same(full.y[i], detail.y[i])) {
+				visibleDiffer++;
+			}
+		}
+	}
+	printf("level of detail: full %8.3f ms/step, detail %8.3f ms/step, %.1fx\n",
+		fullTime * 1000.0 / steps, detailTime * 1000.0 / steps, fullTime / detailTime);
+	printf("%d of %d enemies in camera range differ, %s\n", visibleDiffer, visible, visibleDiffer == 0 ? "ok" : "WRONG");
+	return mismatches == 0 && visibleDiffer == 0 ? 0 : 1;
+}
@@ -0,0 +1,32 @@
+// Compiles Flare .txt levels into the binary .oofl format the game can map
+// straight into memory (see LevelFormat.h).
+//
+// usage: flare2oofl level.txt [level.oofl]
+
+#include "FlareMap.h"
+#include "helper.h"
+#include <cstdio>
+#include <string>
+
+int main(int argc, char *argv[])
+{
+	if (argc < 2) {
+		printf("usage: %s level.txt [level.oofl]\n", argv[0]);
+		return 1;
+	}
+	std::string input = argv[1];
+	std::string output = argc > 2 ? argv[2] : input.substr(0, input.find_last_of('.')) + ".oofl";
+
+	FlareMap map(TILE_SIZE);
+	if (!map.Load(input)) {
+		printf("%s\n", map.loadError.c_str());
+		return 1;
+	}
+	if (!map.SaveBinary(output)) {
+		printf("%s: unable to write file\n", output.c_str());
+		return 1;
+	}
+	printf("%s: %dx%d tiles, %zu entities of %zu types\n", output.c_str(),
+		map.mapWidth, map.mapHeight, map.entities.size(), map.entityTypes.size());
+	return 0;
+}
@@ -0,0 +1,53 @@
+// An offscreen OpenGL context for the render benchmarks, created through EGL
+// so no window system or SDL is needed (Mesa's llvmpipe works).
+#ifndef HEADLESSGL_H
+#define HEADLESSGL_H
+
+#include "glhelper.h"
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <cstdio>
+
+inline bool CreateHeadlessContext(int width, int height) {
+	EGLDisplay display = EGL_NO_DISPLAY;
+	PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+		(PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+	if (getPlatformDisplay) {
+		display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+	}
+	if (display == EGL_NO_DISPLAY) {
+		display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+	}
+	EGLint major, minor;
+	if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor)) {
+		printf("unable to initialize EGL\n");
+		return false;
+	}
+
+	const EGLint configAttributes[] = {
+		EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+		EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8,
+		EGL_NONE
+	};
+	EGLConfig config;
+	EGLint configCount = 0;
+	if (!eglChooseConfig(display, configAttributes, &config, 1, &configCount) || configCount == 0) {
+		printf("no EGL config for desktop OpenGL\n");
+		return false;
+	}
+	eglBindAPI(EGL_OPENGL_API);
+
+	const EGLint surfaceAttributes[] = { EGL_WIDTH, width, EGL_HEIGHT, height, EGL_NONE };
+	EGLSurface surface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+	EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, NULL);
+	if (surface == EGL_NO_SURFACE || context == EGL_NO_CONTEXT ||
+		!eglMakeCurrent(display, surface, surface, context)) {
+		printf("unable to create an OpenGL context\n");
+		return false;
+	}
+	glViewport(0, 0, width, height);
+	return true;
+}
+
+#endif
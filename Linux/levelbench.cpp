@@ -0,0 +1,180 @@
+// Times FlareMap::Load against the old stream based loader on a generated
+// multi-megabyte level and checks that both read the same tiles, then times
+// loading the same level compiled to .oofl.
+//
+// usage: levelbench [width] [height] [runs]
+
+#include "benchlevel.h"
+#include "FlareMap.h"
+#include "helper.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct LegacyEntity {
+	std::string type;
+	float x;
+	float y;
+};
+
+// the loader FlareMap used before it parsed the mapped file in place
+struct LegacyLevel {
+	int mapWidth = -1;
+	int mapHeight = -1;
+	std::vector<unsigned int> mapData;
+	std::vector<LegacyEntity> entities;
+
+	bool Load(const std::string& fileName) {
+		std::ifstream infile(fileName);
+		if (infile.fail()) {
+			return false;
+		}
+		std::string line;
+		while (std::getline(infile, line)) {
+			if (line == "[header]") {
+				ReadHeader(infile);
+			}
+			else if (line == "[layer]") {
+				ReadLayerData(infile);
+			}
+			else if (line == "[ObjectsLayer]") {
+				ReadEntityData(infile);
+			}
+		}
+		return mapWidth != -1 && mapHeight != -1;
+	}
+
+	void ReadHeader(std::ifstream &stream) {
+		std::string line;
+		while (std::getline(stream, line)) {
+			if (line == "") { break; }
+			std::istringstream sStream(line);
+			std::string key, value;
+			std::getline(sStream, key, '=');
+			std::getline(sStream, value);
+			if (key == "width") {
+				mapWidth = std::atoi(value.c_str());
+			}
+			else if (key == "height") {
+				mapHeight = std::atoi(value.c_str());
+			}
+		}
+		mapData.assign((size_t)mapWidth * mapHeight, 0);
+	}
+
+	void ReadLayerData(std::ifstream &stream) {
+		std::string line;
+		while (getline(stream, line)) {
+			if (line == "") { break; }
+			std::istringstream sStream(line);
+			std::string key, value;
+			std::getline(sStream, key, '=');
+			std::getline(sStream, value);
+			if (key == "data") {
+				for (int y = 0; y < mapHeight; y++) {
+					getline(stream, line);
+					std::istringstream lineStream(line);
+					std::string tile;
+					for (int x = 0; x < mapWidth; x++) {
+						std::getline(lineStream, tile, ',');
+						unsigned int val = atoi(tile.c_str());
+						mapData[(size_t)y * mapWidth + x] = val > 0 ? val - 1 : -1;
+					}
+				}
+			}
+		}
+	}
+
+	void ReadEntityData(std::ifstream &stream) {
+		std::string line;
+		std::string type;
+		while (getline(stream, line)) {
+			if (line == "") { break; }
+			std::istringstream sStream(line);
+			std::string key, value;
+			getline(sStream, key, '=');
+			getline(sStream, value);
+			if (key == "type") {
+				type = value;
+			}
+			else if (key == "location") {
+				std::istringstream lineStream(value);
+				std::string xPosition, yPosition;
+				getline(lineStream, xPosition, ',');
+				getline(lineStream, yPosition, ',');
+				LegacyEntity newEntity;
+				newEntity.type = type;
+				newEntity.x = std::atoi(xPosition.c_str()) * TILE_SIZE;
+				newEntity.y = std::atoi(yPosition.c_str()) * -TILE_SIZE;
+				entities.push_back(newEntity);
+			}
+		}
+	}
+};
+
+int main(int argc, char *argv[])
+{
+	int width = argc > 1 ? std::atoi(argv[1]) : 40000;
+	int height = argc > 2 ? std::atoi(argv[2]) : 60;
+	int runs = argc > 3 ? std::atoi(argv[3]) : 5;
+	std::string fileName = "levelbench.txt";
+
+	WriteBenchLevel(fileName, width, height);
+	std::ifstream sizeCheck(fileName, std::ios::binary | std::ios::ate);
+	double megabytes = (double)sizeCheck.tellg() / (1024.0 * 1024.0);
+
+	LegacyLevel legacy;
+	double legacyTime = BestOf(runs, [&]() {
+		legacy = LegacyLevel();
+		legacy.Load(fileName);
+	});
+
+	FlareMap map(TILE_SIZE);
+	double mappedTime = BestOf(runs, [&]() {
+		map = FlareMap(TILE_SIZE);
+		if (!map.Load(fileName)) {
+			printf("%s\n", map.loadError.c_str());
+			exit(1);
+		}
+	});
+
+	std::string binaryName = "levelbench.oofl";
+	if (!map.SaveBinary(binaryName)) {
+		printf("%s: unable to write file\n", binaryName.c_str());
+		return 1;
+	}
+	FlareMap compiled(TILE_SIZE);
+	double binaryTime = BestOf(runs, [&]() {
+		compiled = FlareMap(TILE_SIZE);
+		if (!compiled.Load(binaryName)) {
+			printf("%s\n", compiled.loadError.c_str());
+			exit(1);
+		}
+	});
+
+	int mismatches = 0;
+	for (int y = 0; y < height; y++) {
+		for (int x = 0; x < width; x++) {
+			unsigned int expected = legacy.mapData[(size_t)y * width + x];
+			unsigned int tile = map.mapData(x, y) == TileGrid<TileID>::EMPTY ? (unsigned int)-1 : map.mapData(x, y);
+			if (tile != expected || compiled.mapData(x, y) != map.mapData(x, y)) {
+				mismatches++;
+			}
+		}
+	}
+	if (legacy.entities.size() != map.entities.size() || compiled.entities.size() != map.entities.size()) {
+		mismatches++;
+	}
+
+	printf("%dx%d level, %.1f MB\n", width, height, megabytes);
+	printf("stream loader: %8.2f ms (%6.1f MB/s)\n", legacyTime * 1000.0, megabytes / legacyTime);
+	printf("mapped loader: %8.2f ms (%6.1f MB/s)\n", mappedTime * 1000.0, megabytes / mappedTime);
+	printf("compiled .oofl: %8.2f ms\n", binaryTime * 1000.0);
+	printf("speedup %.1fx parsing, %.0fx compiled, %d mismatching tiles\n",
+		legacyTime / mappedTime, legacyTime / binaryTime, mismatches);
+	return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,64 @@
+// Plays the game headless with a scripted input and reports how much faster
+// than real time the simulation runs.
+//
+// usage: simrun [steps] [resource folder]
+
+#include "Simulation.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+int main(int argc, char *argv[])
+{
+	int steps = argc > 1 ? std::atoi(argv[1]) : 1000000;
+	std::string folder = argc > 2 ? argv[2] : GAME_RESOURCE_FOLDER;
+
+	Simulation sim;
+	if (!sim.Load(folder)) {
+		return 1;
+	}
+
+	SimInput input;
+	int deaths = 0;
+	int cleared = 0;
+	int wins = 0;
+
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < steps; i++) {
+		// keep running right, hop every so often, skip ahead when stuck and
+		// restart whenever a run ends
+		input.ClearPresses();
+		input.right = true;
+		input.jump = (i % 45) < 3;
+		input.barrierDown = (i % 90) == 0;
+		input.wallJumpRight = (i % 30) == 0;
+		input.skipLevel = (i % 1200) == 1199;
+		if (sim.mode == STATE_MAIN_MENU || sim.mode == STATE_GAME_OVER || sim.mode == STATE_WIN) {
+			input.start = true;
+		}
+
+		GameMode before = sim.mode;
+		if (sim.Step(input) & SIM_EVENT_LEVEL_CLEARED) {
+			cleared++;
+		}
+		if (sim.mode != before) {
+			if (sim.mode == STATE_GAME_OVER) {
+				deaths++;
+			}
+			else if (sim.mode == STATE_WIN) {
+				wins++;
+			}
+		}
+	}
+	std::chrono::duration<double> wall = std::chrono::steady_clock::now() - start;
+
+	double simulated = steps * (double)FIXED_TIMESTEP;
+	printf("%d steps (%.1f s of game time) in %.3f s wall time\n", steps, simulated, wall.count());
+	printf("%.0f steps/s, %.0fx real time\n", steps / wall.count(), simulated / wall.count());
+	// every barrier handed out is either still up or was given back
+	printf("barriers: %lld spawned, %lld released, %d up, peak %d\n",
+		sim.barriers.Acquired(), sim.barriers.Released(), sim.barriers.Live(), sim.barriers.Peak());
+	printf("levels cleared: %d, deaths: %d, wins: %d\n", cleared, deaths, wins);
+	return 0;
+}
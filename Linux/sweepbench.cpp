@@ -0,0 +1,197 @@
+// Checks SweepTiles and TilesAtFaces on a long strip of a level: boxes
+// landing on floors, hitting ceilings and walls, walking into one tile walls
+// far along the level where float positions round coarsely, moving several
+// tiles in one step, and standing on spikes with their middle or a corner.
+// Then times SweepTiles for boxes walking along the strip.
+//
+// usage: sweepbench [steps]
+
+#include "benchlevel.h"
+#include "FlareMap.h"
+#include "TileSweep.h"
+#include "helper.h"
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+static const int WIDTH = 33200;
+static const int HEIGHT = 8;
+
+// rows of the strip: a ceiling, open air the walls stand in, and a floor
+static const int CEILING_ROW = 1;
+static const int AIR_ROW = 4;
+static const int FLOOR_ROW = 7;
+
+// tile ids as they are in the Flare file, one more than in the map
+static const int FILE_SOLID = 35;
+static const int FILE_SPIKES = 101;
+
+// columns where the walls stand, including ones where a tile's edge is
+// hundreds of world units out and past what a GLshort holds
+static const int WALLS[] = { 20, 2828, 3683, 4000, 20000, 32769, 33000 };
+static const float WIDTHS[] = { 0.05f, 0.061f, 0.08f, 0.099f, 0.123f };
+static const float BOX_HEIGHT = TILE_SIZE;
+static const int SPIKES = 60;
+
+static int failures = 0;
+
+static void Check(bool ok, const char* what, int column, float width) {
+	if (!ok) {
+		failures++;
+		if (failures <= 20) {
+			printf("  WRONG: %s, column %d, width %.3f\n", what, column, width);
+		}
+	}
+}
+
+// slack in world units for a position placed flush against a tile's face
+static float Slack(float position) {
+	return std::max(1.0e-6f, fabsf(position) * 8.0f * FLT_EPSILON);
+}
+
+static bool WriteLevel(const std::string& fileName) {
+	std::vector<std::vector<int>> tiles(HEIGHT, std::vector<int>(WIDTH, 0));
+	for (int x = 0; x < WIDTH; x++) {
+		tiles[CEILING_ROW][x] = FILE_SOLID;
+		tiles[FLOOR_ROW][x] = FILE_SOLID;
+	}
+	for (int wall : WALLS) {
+		tiles[AIR_ROW][wall] = FILE_SOLID;
+	}
+	tiles[FLOOR_ROW][SPIKES] = FILE_SPIKES;
+
+	std::ofstream out(fileName);
+	out << "[header]\nwidth=" << WIDTH << "\nheight=" << HEIGHT << "\ntilewidth=16\ntileheight=16\n\n";
+	out << "[layer]\ntype=Tile Layer 1\ndata=\n";
+	for (int y = 0; y < HEIGHT; y++) {
+		std::string row;
+		for (int x = 0; x < WIDTH; x++) {
+			row += std::to_string(tiles[y][x]);
+			if (x + 1 < WIDTH || y + 1 < HEIGHT) {
+				row += ',';
+			}
+		}
+		out << row << "\n";
+	}
+	out << "\n";
+	return !out.fail();
+}
+
+// drops a box onto the floor and raises one into the ceiling, a step at a time
+static void CheckFloorAndCeiling(const FlareMap& map, int column, float width) {
+	float x = (column + 0.5f) * TILE_SIZE;
+	float y = -AIR_ROW * TILE_SIZE;
+	TileSweep sweep;
+	for (int i = 0; i < 100 && !sweep.normalY; i++) {
+		sweep = SweepTiles(map, x, y, width, BOX_HEIGHT, 0.0f, -0.0137f);
+	}
+	float floor = -FLOOR_ROW * TILE_SIZE;
+	Check(sweep.normalY == 1 && fabsf(y - BOX_HEIGHT * 0.5f - floor) <= Slack(floor), "not flush on the floor", column, width);
+	// resting on it, and sliding along it
+	sweep = SweepTiles(map, x, y, width, BOX_HEIGHT, 0.01f, -0.0005f);
+	Check(sweep.normalY == 1 && !sweep.normalX && fabsf(y - BOX_HEIGHT * 0.5f - floor) <= Slack(floor), "doesn't rest on the floor", column, width);
+
+	y = -AIR_ROW * TILE_SIZE;
+	sweep = TileSweep();
+	for (int i = 0; i < 100 && !sweep.normalY; i++) {
+		sweep = SweepTiles(map, x, y, width, BOX_HEIGHT, 0.0f, 0.0137f);
+	}
+	float ceiling = -(CEILING_ROW + 1) * TILE_SIZE;
+	Check(sweep.normalY == -1 && fabsf(y + BOX_HEIGHT * 0.5f - ceiling) <= Slack(ceiling), "not flush under the ceiling", column, width);
+}
+
+// walks a box into the wall at column from both sides at dx a step
+static void CheckWall(const FlareMap& map, int column, float width, float dx) {
+	float y = -(AIR_ROW + 0.5f) * TILE_SIZE;
+	float face = column * TILE_SIZE;
+	float x = face - 3.0f * TILE_SIZE;
+	bool through = false;
+	// enough steps to reach the wall from three tiles out and push on it
+	int steps = (int)(4.0f * TILE_SIZE / dx) + 2;
+	TileSweep sweep;
+	for (int i = 0; i < steps; i++) {
+		sweep = SweepTiles(map, x, y, width, BOX_HEIGHT, dx, 0.0f);
+		through |= x + width * 0.5f > face + Slack(face);
+	}
+	Check(!through, "walked into a wall on its right", column, width);
+	Check(sweep.normalX == -1 && fabsf(x + width * 0.5f - face) <= Slack(face), "not flush against a wall on its right", column, width);
+
+	face = (column + 1) * TILE_SIZE;
+	x = face + 3.0f * TILE_SIZE;
+	through = false;
+	sweep = TileSweep();
+	for (int i = 0; i < steps; i++) {
+		sweep = SweepTiles(map, x, y, width, BOX_HEIGHT, -dx, 0.0f);
+		through |= x - width * 0.5f < face - Slack(face);
+	}
+	Check(!through, "walked into a wall on its left", column, width);
+	Check(sweep.normalX == 1 && fabsf(x - width * 0.5f - face) <= Slack(face), "not flush against a wall on its left", column, width);
+}
+
+// a spike under the middle of the bottom face counts, one under a corner doesn't
+static void CheckSpikes(const FlareMap& map, float width) {
+	float floor = -FLOOR_ROW * TILE_SIZE;
+	float x = (SPIKES + 0.5f) * TILE_SIZE;
+	float y = floor + TILE_SIZE;
+	SweepTiles(map, x, y, width, BOX_HEIGHT, 0.0f, -TILE_SIZE);
+	Check((TilesAtFaces(map, x, y, width, BOX_HEIGHT) & TILE_DANGER) != 0, "missed spikes under the middle", SPIKES, width);
+
+	x = SPIKES * TILE_SIZE - width * 0.25f;
+	y = floor + TILE_SIZE;
+	SweepTiles(map, x, y, width, BOX_HEIGHT, 0.0f, -TILE_SIZE);
+	Check((TilesAtFaces(map, x, y, width, BOX_HEIGHT) & TILE_DANGER) == 0, "hurt by spikes under a corner", SPIKES, width);
+}
+
+int main(int argc, char *argv[])
+{
+	int steps = argc > 1 ? std::atoi(argv[1]) : 1000000;
+
+	std::string fileName = "sweepbench.txt";
+	FlareMap map(TILE_SIZE);
+	if (!WriteLevel(fileName) || !map.Load(fileName)) {
+		printf("%s\n", map.loadError.c_str());
+		return 1;
+	}
+
+	for (int column : WALLS) {
+		for (float width : WIDTHS) {
+			CheckFloorAndCeiling(map, column - 2, width);
+			CheckWall(map, column, width, 0.0137f);
+			// creeping up on it, ending steps a rounding error short of the face
+			for (float dx = 0.001f; dx < 0.0137f; dx *= 1.37f) {
+				CheckWall(map, column, width, dx);
+			}
+			// a wall jump's push, and six steps' worth of a run after a hitch
+			CheckWall(map, column, width, TILE_SIZE * 20.0f * FIXED_TIMESTEP);
+			CheckWall(map, column, width, 0.0137f * MAX_TIMESTEPS);
+			// further than a tile in one step
+			CheckWall(map, column, width, TILE_SIZE * 2.5f);
+		}
+	}
+	for (float width : WIDTHS) {
+		CheckSpikes(map, width);
+	}
+	bool ok = failures == 0;
+	printf("floors, ceilings, %d walls and spikes: %d failures, %s\n", (int)(sizeof(WALLS) / sizeof(WALLS[0])), failures, ok ? "ok" : "WRONG");
+
+	// boxes running along the floor, as enemies chasing the player do
+	int boxes = 1000;
+	std::vector<float> x(boxes);
+	std::vector<float> y(boxes);
+	double time = BestOf(3, [&]() {
+		for (int i = 0; i < boxes; i++) {
+			x[i] = (float)(i * 29 % (WIDTH - 4) + 2) * TILE_SIZE;
+			y[i] = -FLOOR_ROW * TILE_SIZE + BOX_HEIGHT * 0.5f;
+		}
+		for (int s = 0; s < steps; s++) {
+			int i = s % boxes;
+			SweepTiles(map, x[i], y[i], 0.08f, BOX_HEIGHT, (i & 1) ? 0.0137f : -0.0137f, -0.0005f);
+		}
+	});
+	printf("%d sweeps: %.1f ns each\n", steps, time * 1.0e9 / steps);
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,100 @@
+// Checks that TextMesh only re-uploads the glyphs that change, then times a
+// counter that ticks every frame drawn through TextCache keyed by its string
+// (a new mesh per value) against drawn through one slot (one mesh updated in
+// place).
+//
+// usage: textbench [frames]
+
+#include "headlessgl.h"
+#include "benchlevel.h"
+#include "ShaderProgram.h"
+#include "SpriteSheet.h"
+#include "TextCache.h"
+#include "helper.h"
+#include "glm/mat4x4.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+static const float SIZE = 0.05f;
+
+// the glyphs one Set of to uploads after from
+static int GlyphsChanged(const SpriteSheet& font, const std::string& from, const std::string& to) {
+	TextMesh mesh;
+	mesh.Set(font, from, SIZE, 0.0f);
+	int before = mesh.UploadedGlyphs();
+	mesh.Set(font, to, SIZE, 0.0f);
+	return mesh.UploadedGlyphs() - before;
+}
+
+static bool Expect(const SpriteSheet& font, const std::string& from, const std::string& to, int glyphs) {
+	int uploaded = GlyphsChanged(font, from, to);
+	printf("%-8s -> %-8s %d glyphs uploaded, expected %d\n", from.c_str(), to.c_str(), uploaded, glyphs);
+	return uploaded == glyphs;
+}
+
+static std::string Counter(int frame) {
+	char text[32];
+	snprintf(text, sizeof(text), "TIME %06d", frame);
+	return text;
+}
+
+int main(int argc, char *argv[])
+{
+	int frames = argc > 1 ? std::atoi(argv[1]) : 600;
+
+	if (!CreateHeadlessContext(64, 64)) {
+		return 1;
+	}
+	ShaderProgram program;
+	program.Load(GAME_RESOURCE_FOLDER"vertex_textured.glsl", GAME_RESOURCE_FOLDER"fragment_textured.glsl");
+	SpriteSheet font(LoadTexture(GAME_RESOURCE_FOLDER"font1.png"), 16, 16);
+
+	bool ok = Expect(font, "STOP!", "START", 3);
+	ok &= Expect(font, "STOP!", "STOP!", 0);
+	ok &= Expect(font, "TIME 09", "TIME 10", 2);
+	// a longer string lays out the new glyphs past the old end
+	ok &= Expect(font, "GO", "GO ON", 3);
+	// a new size moves every glyph
+	TextMesh resized;
+	resized.Set(font, "START", SIZE, 0.0f);
+	resized.Set(font, "START", SIZE * 2.0f, 0.0f);
+	printf("START at twice the size %d glyphs uploaded, expected 10\n", resized.UploadedGlyphs());
+	ok &= resized.UploadedGlyphs() == 10;
+
+	size_t byStringMeshes = 0;
+	double byStringTime = BestOf(3, [&]() {
+		TextCache texts;
+		for (int i = 0; i < frames; i++) {
+			texts.Get(font, Counter(i), SIZE, 0.0f).Draw(program, font, 0.0f, 0.0f);
+			texts.EndFrame();
+		}
+		glFinish();
+		byStringMeshes = texts.Size();
+	});
+
+	size_t bySlotMeshes = 0;
+	int bySlotGlyphs = 0;
+	double bySlotTime = BestOf(3, [&]() {
+		TextCache texts;
+		for (int i = 0; i < frames; i++) {
+			TextMesh& mesh = texts.Get(0, font, Counter(i), SIZE, 0.0f);
+			mesh.Draw(program, font, 0.0f, 0.0f);
+			bySlotGlyphs = mesh.UploadedGlyphs();
+			texts.EndFrame();
+		}
+		glFinish();
+		bySlotMeshes = texts.Size();
+	});
+
+	// the first value uploads every glyph, each tick after mostly one
+	int length = (int)Counter(0).size();
+	bool slotOk = bySlotMeshes == 1 && bySlotGlyphs < length + frames * 2;
+	printf("counter over %d frames:\n", frames);
+	printf("  keyed by string: %8.3f ms, %d meshes alive\n", byStringTime * 1000.0, (int)byStringMeshes);
+	printf("  one slot:        %8.3f ms, %d mesh, %d glyphs uploaded\n", bySlotTime * 1000.0, (int)bySlotMeshes, bySlotGlyphs);
+	ok &= slotOk;
+	printf("%s\n", ok ? "ok" : "WRONG");
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,260 @@
+// Frame time of drawing a large level's tiles the old way (vertex arrays
+// rebuilt on the CPU and streamed every frame) against the cached TileMesh,
+// drawn whole and culled to the camera, and against the TileMapRenderer
+// shader, with the camera panning across the level. The old path draws from
+// the sheet on its own, the others from the game's texture atlas. The whole
+// and culled mesh must draw the same image. The others round positions and
+// UVs a little differently, so against the old path only a few pixels on
+// texel edges may differ.
+//
+// usage: tilebench [width] [height] [frames]
+
+#include "headlessgl.h"
+#include "benchlevel.h"
+#include "FlareMap.h"
+#include "ShaderProgram.h"
+#include "SpriteSheet.h"
+#include "TileMesh.h"
+#include "TileMapRenderer.h"
+#include "TextureAtlas.h"
+#include "RenderBackend.h"
+#include "RenderState.h"
+#include "helper.h"
+#include "glm/mat4x4.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+static const int VIEW_WIDTH = 640;
+static const int VIEW_HEIGHT = 360;
+
+// GameState::DrawTiles before the tiles were cached in a buffer
+static void LegacyDrawTiles(const FlareMap& map, const SpriteSheet& Texture, const ShaderProgram& program) {
+	std::vector<float> vertexData;
+	std::vector<float> texCoordData;
+	const int chunkSize = TileGrid<TileID>::CHUNK_SIZE;
+	for (int cy = 0; cy < map.mapData.ChunksY(); cy++) {
+		for (int cx = 0; cx < map.mapData.ChunksX(); cx++) {
+			if (map.ChunkAt(cx, cy).Empty()) {
+				continue;
+			}
+			int endY = std::min((cy + 1) * chunkSize, map.mapHeight);
+			int endX = std::min((cx + 1) * chunkSize, map.mapWidth);
+			for (int y = cy * chunkSize; y < endY; y++) {
+				for (int x = cx * chunkSize; x < endX; x++) {
+					TileID tile = map.mapData(x, y);
+					if (tile != TileGrid<TileID>::EMPTY) {
+						float u = (float)(((int)tile) % Texture.spriteCountX) / (float)Texture.spriteCountX;
+						float v = (float)(((int)tile) / Texture.spriteCountX) / (float)Texture.spriteCountY;
+						float spriteWidth = 1.0f / (float)Texture.spriteCountX;
+						float spriteHeight = 1.0f / (float)Texture.spriteCountY;
+						vertexData.insert(vertexData.end(), {
+							TILE_SIZE * x, -TILE_SIZE * y,
+							TILE_SIZE * x, (-TILE_SIZE * y) - TILE_SIZE,
+							(TILE_SIZE * x) + TILE_SIZE, (-TILE_SIZE * y) - TILE_SIZE,
+							TILE_SIZE * x, -TILE_SIZE * y,
+							(TILE_SIZE * x) + TILE_SIZE, (-TILE_SIZE * y) - TILE_SIZE,
+							(TILE_SIZE * x) + TILE_SIZE, -TILE_SIZE * y
+							});
+						texCoordData.insert(texCoordData.end(), {
+							u, v,
+							u, v + (spriteHeight),
+							u + spriteWidth, v + (spriteHeight),
+							u, v,
+							u + spriteWidth, v + (spriteHeight),
+							u + spriteWidth, v
+							});
+					}
+				}
+			}
+		}
+	}
+
+	glUseProgram(program.programID);
+	glVertexAttribPointer(program.positionAttribute, 2, GL_FLOAT, false, 0, vertexData.data());
+	glEnableVertexAttribArray(program.positionAttribute);
+	glVertexAttribPointer(program.texCoordAttribute, 2, GL_FLOAT, false, 0, texCoordData.data());
+	glEnableVertexAttribArray(program.texCoordAttribute);
+	glBindTexture(GL_TEXTURE_2D, Texture.textureID);
+	glDrawArrays(GL_TRIANGLES, 0, vertexData.size() / 2);
+	glDisableVertexAttribArray(program.positionAttribute);
+	glDisableVertexAttribArray(program.texCoordAttribute);
+	// this went around the render state cache
+	renderState.Invalidate();
+}
+
+static glm::mat4 cameraMatrix;
+
+// points the camera at a spot along the level, the way RenderLevel follows the player
+static WorldRect SetCamera(ShaderProgram& program, const FlareMap& map, int frame, int frames) {
+	float x = (float)frame / (float)std::max(frames - 1, 1) * map.mapWidth * TILE_SIZE;
+	float y = -map.mapHeight * TILE_SIZE * 0.5f;
+	float xOffset = std::min(std::max(-x, ((float)map.mapWidth * -TILE_SIZE) + 1.777f), -1.777f);
+	cameraMatrix = glm::translate(glm::mat4(1.0f), glm::vec3(xOffset, -y, 0.0f));
+	program.SetModelMatrix(glm::mat4(1.0f));
+	program.SetViewMatrix(cameraMatrix);
+
+	WorldRect view;
+	view.left = -xOffset - VIEW_HALF_WIDTH;
+	view.right = -xOffset + VIEW_HALF_WIDTH;
+	view.bottom = y - VIEW_HALF_HEIGHT;
+	view.top = y + VIEW_HALF_HEIGHT;
+	return view;
+}
+
+static std::vector<unsigned int> ReadImage() {
+	std::vector<unsigned int> pixels(VIEW_WIDTH * VIEW_HEIGHT);
+	glReadPixels(0, 0, VIEW_WIDTH, VIEW_HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+	return pixels;
+}
+
+static int DifferentPixels(const std::vector<unsigned int>& a, const std::vector<unsigned int>& b) {
+	int count = 0;
+	for (size_t i = 0; i < a.size(); i++) {
+		count += a[i] != b[i];
+	}
+	return count;
+}
+
+template <typename F>
+static double FrameTime(ShaderProgram& program, const FlareMap& map, int frames, F draw) {
+	return BestOf(3, [&]() {
+		for (int i = 0; i < frames; i++) {
+			glClear(GL_COLOR_BUFFER_BIT);
+			draw(SetCamera(program, map, i, frames));
+			glFinish();
+		}
+	}) / frames;
+}
+
+int main(int argc, char *argv[])
+{
+	int width = argc > 1 ? std::atoi(argv[1]) : 4000;
+	int height = argc > 2 ? std::atoi(argv[2]) : 200;
+	int frames = argc > 3 ? std::atoi(argv[3]) : 60;
+
+	if (!CreateHeadlessContext(VIEW_WIDTH, VIEW_HEIGHT)) {
+		return 1;
+	}
+	printf("%s\n", (const char*)glGetString(GL_RENDERER));
+
+	ShaderProgram program;
+	program.Load(GAME_RESOURCE_FOLDER"vertex_textured.glsl", GAME_RESOURCE_FOLDER"fragment_textured.glsl");
+	glm::mat4 projectionMatrix = glm::ortho(-VIEW_HALF_WIDTH, VIEW_HALF_WIDTH, -VIEW_HALF_HEIGHT, VIEW_HALF_HEIGHT, -1.0f, 1.0f);
+	program.SetProjectionMatrix(projectionMatrix);
+	TileMapRenderer tileMap;
+	if (!tileMap.Load(GAME_RESOURCE_FOLDER"vertex_tilemap.glsl", GAME_RESOURCE_FOLDER"fragment_tilemap.glsl", projectionMatrix)) {
+		printf("the tile map shader doesn't build on this GL\n");
+		return 1;
+	}
+	renderState.UseProgram(program.programID);
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	SpriteSheet sheet(LoadTexture(GAME_RESOURCE_FOLDER"arne_sprites.png"), 16, 8);
+	// packed the way GameState::Load packs it
+	TextureAtlas atlas;
+	atlas.Add(GAME_RESOURCE_FOLDER"font1.png", 16, 16);
+	int tileSheet = atlas.Add(GAME_RESOURCE_FOLDER"arne_sprites.png", 16, 8);
+	atlas.Add(GAME_RESOURCE_FOLDER"yooyoo.png", 6, 4);
+	atlas.Build();
+	const SpriteSheet& atlasSheet = atlas.Sheet(tileSheet);
+
+	std::string fileName = "tilebench.txt";
+	WriteBenchLevel(fileName, width, height);
+	FlareMap map(TILE_SIZE);
+	if (!map.Load(fileName)) {
+		printf("%s\n", map.loadError.c_str());
+		return 1;
+	}
+
+	TileMesh mesh;
+	double buildTime = BestOf(1, [&]() {
+		mesh.Update(map, atlasSheet);
+		glFinish();
+	});
+
+	double legacyTime = FrameTime(program, map, frames, [&](const WorldRect&) {
+		LegacyDrawTiles(map, sheet, program);
+	});
+	double cachedTime = FrameTime(program, map, frames, [&](const WorldRect&) {
+		mesh.Update(map, atlasSheet);
+		renderState.UseProgram(program.programID);
+		mesh.Draw(program, atlasSheet.textureID);
+	});
+	renderState.ResetCounters();
+	double culledTime = FrameTime(program, map, frames, [&](const WorldRect& view) {
+		mesh.Update(map, atlasSheet);
+		renderState.UseProgram(program.programID);
+		mesh.Draw(program, atlasSheet.textureID, map.ChunksIn(view));
+	});
+	std::string culledCalls = renderState.Report();
+
+	// levels wider or taller than a texture can be are left to the mesh
+	bool shader = tileMap.Update(map);
+	double shaderTime = 0.0;
+	if (shader) {
+		shaderTime = FrameTime(program, map, frames, [&](const WorldRect& view) {
+			tileMap.Update(map);
+			tileMap.Draw(map, atlasSheet, cameraMatrix, view);
+		});
+	}
+
+	// the same frame drawn every way
+	glClear(GL_COLOR_BUFFER_BIT);
+	WorldRect view = SetCamera(program, map, frames / 2, frames);
+	LegacyDrawTiles(map, sheet, program);
+	std::vector<unsigned int> legacyImage = ReadImage();
+	glClear(GL_COLOR_BUFFER_BIT);
+	mesh.Draw(program, atlasSheet.textureID);
+	std::vector<unsigned int> cachedImage = ReadImage();
+	glClear(GL_COLOR_BUFFER_BIT);
+	mesh.Draw(program, atlasSheet.textureID, map.ChunksIn(view));
+	std::vector<unsigned int> culledImage = ReadImage();
+	int shaderDifferences = 0;
+	if (shader) {
+		glClear(GL_COLOR_BUFFER_BIT);
+		tileMap.Draw(map, atlasSheet, cameraMatrix, view);
+		shaderDifferences = DifferentPixels(legacyImage, ReadImage());
+	}
+	int differences = DifferentPixels(legacyImage, cachedImage);
+	int tolerance = VIEW_WIDTH * VIEW_HEIGHT / 200;
+	bool match = DifferentPixels(cachedImage, culledImage) == 0 && differences < tolerance && shaderDifferences < tolerance;
+
+	// one tile changing only rebuilds its chunk
+	map.SetTile(width / 2, height - 1, 35);
+	double editTime = BestOf(1, [&]() {
+		mesh.Update(map, atlasSheet);
+		glFinish();
+	});
+	double shaderEditTime = BestOf(1, [&]() {
+		if (shader) {
+			tileMap.Update(map);
+		}
+		glFinish();
+	});
+
+	// six float x, y, u, v vertices per tile before, four packed ones now
+	double floatMegabytes = mesh.QuadCount() * 6.0 * 4.0 * sizeof(float) / (1024.0 * 1024.0);
+	double packedMegabytes = mesh.QuadCount() * 4.0 * sizeof(TileVertex) / (1024.0 * 1024.0);
+	printf("%dx%d level, %d tiles, %.1f MB of vertices (%.1f MB as float triangles)\n",
+		width, height, mesh.QuadCount(), packedMegabytes, floatMegabytes);
+	printf("client arrays: %8.3f ms/frame\n", legacyTime * 1000.0);
+	printf("cached mesh:   %8.3f ms/frame (built in %.3f ms, one tile edit %.3f ms)\n",
+		cachedTime * 1000.0, buildTime * 1000.0, editTime * 1000.0);
+	printf("culled mesh:   %8.3f ms/frame\n", culledTime * 1000.0);
+	printf("  GL state calls over %d culled frames: %s\n", frames * 3, culledCalls.c_str());
+	if (shader) {
+		printf("tile shader:   %8.3f ms/frame (one tile edit %.3f ms)\n", shaderTime * 1000.0, shaderEditTime * 1000.0);
+		printf("speedup %.1fx cached, %.1fx culled, %.1fx shader\n",
+			legacyTime / cachedTime, legacyTime / culledTime, legacyTime / shaderTime);
+	}
+	else {
+		printf("tile shader:   skipped, level larger than a texture\n");
+		printf("speedup %.1fx cached, %.1fx culled\n", legacyTime / cachedTime, legacyTime / culledTime);
+	}
+	printf("pixels differing from client arrays out of %d: %d mesh, %d shader, %s\n",
+		VIEW_WIDTH * VIEW_HEIGHT, differences, shaderDifferences, match ? "ok" : "WRONG");
+	return match ? 0 : 1;
+}
@@ -0,0 +1,15 @@
+#include "Animation.h"
+
+static const AnimationClip clips[CLIP_COUNT] = {
+    { { 0, 1, 2 } },
+    { { 6, 7, 8 } },
+    { { 12, 13, 14 } },
+    { { 60, 76 } },
+    { { 48,48,48,48, 49,49,49,49, 50,50,50,50 } },
+    { { 39 } },
+    { { 38 } }
+};
+
+const AnimationClip& GetClip(AnimationClipID clip) {
+    return clips[clip];
+}
@@ -0,0 +1,27 @@
+#ifndef ANIMATION_H
+#define ANIMATION_H
+
+#include <vector>
+
+// Every animation in the game. Entities refer to their clips by id and the
+// frame lists are shared, so the renderer can resolve each clip's frames to
+// texture coordinates once instead of per sprite.
+enum AnimationClipID {
+	CLIP_PLAYER_IDLE,
+	CLIP_PLAYER_FORWARD,
+	CLIP_PLAYER_BACKWARD,
+	CLIP_ENEMY,
+	CLIP_VICTORY,
+	CLIP_BARRIER_UP,
+	CLIP_BARRIER_DOWN,
+	CLIP_COUNT
+};
+
+struct AnimationClip {
+	// frames of the entity's sprite sheet, in the order they play
+	std::vector<int> frames;
+};
+
+const AnimationClip& GetClip(AnimationClipID clip);
+
+#endif
@@ -0,0 +1,412 @@
+#include "Enemies.h"
+#include "helper.h"
+#include "TileSweep.h"
+#include <algorithm>
+#include <limits>
+#include <math.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define ENEMY_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ENEMY_SSE2
+#endif
+
+// how fast an awake enemy closes in on the player
+static const float CHASE_SPEED = 0.35f;
+
+// an awake enemy sleeps again this far left of the target, a screen past
+// the camera's edge, or this far below the bottom of the level
+static const float SLEEP_BEHIND = VIEW_HALF_WIDTH * 3.0f;
+static const float SLEEP_BELOW = VIEW_HALF_HEIGHT * 2.0f;
+
+// Awake enemies within NEAR_RANGE of the target step every time, exactly
+// as before. The camera is never more than two half widths from the player,
+// so that leaves half a screen of margin. Ones further out but within
+// COARSE_RANGE take one step of COARSE_INTERVAL times the length every
+// COARSE_INTERVAL steps, and ones beyond that wait where they are.
+static const float NEAR_RANGE = VIEW_HALF_WIDTH * 3.0f;
+static const float COARSE_RANGE = VIEW_HALF_WIDTH * 12.0f;
+static const int COARSE_INTERVAL = 4;
+
+// a power of two; columns this far apart share a bucket
+static const int SLEEP_BUCKETS = 4096;
+
+// The step is written once against these, one per instruction set. F holds
+// a float per enemy, I an int and M a mask.
+
+struct ScalarLanes {
+    static const int WIDTH = 1;
+    typedef float F;
+    typedef int I;
+    typedef bool M;
+
+    static F Load(const float* p) { return *p; }
+    static void Store(float* p, F v) { *p = v; }
+    static I LoadInt(const int* p) { return *p; }
+    static F Set(float v) { return v; }
+    static F Add(F a, F b) { return a + b; }
+    static F Sub(F a, F b) { return a - b; }
+    static F Mul(F a, F b) { return a * b; }
+    static F Abs(F a) { return fabsf(a); }
+    static M Less(F a, F b) { return a < b; }
+    static F Select(M m, F a, F b) { return m ? a : b; }
+    static M And(M a, M b) { return a && b; }
+    static M Or(M a, M b) { return a || b; }
+    static int Bits(M m) { return m ? 1 : 0; }
+    static M HasFlag(I flags, int flag) { return (flags & flag) != 0; }
+};
+
+#ifdef ENEMY_SSE2
+struct SSE2Lanes {
+    static const int WIDTH = 4;
+    typedef __m128 F;
+    typedef __m128i I;
+    typedef __m128 M;
+
+    static F Load(const float* p) { return _mm_loadu_ps(p); }
+    static void Store(float* p, F v) { _mm_storeu_ps(p, v); }
+    static I LoadInt(const int* p) { return _mm_loadu_si128((const __m128i*)p); }
+    static F Set(float v) { return _mm_set1_ps(v); }
+    static F Add(F a, F b) { return _mm_add_ps(a, b); }
+    static F Sub(F a, F b) { return _mm_sub_ps(a, b); }
+    static F Mul(F a, F b) { return _mm_mul_ps(a, b); }
+    static F Abs(F a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+    static M Less(F a, F b) { return _mm_cmplt_ps(a, b); }
+    static F Select(M m, F a, F b) { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+    static M And(M a, M b) { return _mm_and_ps(a, b); }
+    static M Or(M a, M b) { return _mm_or_ps(a, b); }
+    static int Bits(M m) { return _mm_movemask_ps(m); }
+    static M HasFlag(I flags, int flag) {
+        __m128i bit = _mm_set1_epi32(flag);
+        return _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(flags, bit), bit));
+    }
+};
+typedef SSE2Lanes VectorLanes;
+#endif
+
+#ifdef ENEMY_AVX2
+struct AVX2Lanes {
+    static const int WIDTH = 8;
+    typedef __m256 F;
+    typedef __m256i I;
+    typedef __m256 M;
+
+    static F Load(const float* p) { return _mm256_loadu_ps(p); }
+    static void Store(float* p, F v) { _mm256_storeu_ps(p, v); }
+    static I LoadInt(const int* p) { return _mm256_loadu_si256((const __m256i*)p); }
+    static F Set(float v) { return _mm256_set1_ps(v); }
+    static F Add(F a, F b) { return _mm256_add_ps(a, b); }
+    static F Sub(F a, F b) { return _mm256_sub_ps(a, b); }
+    static F Mul(F a, F b) { return _mm256_mul_ps(a, b); }
+    static F Abs(F a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+    static M Less(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static F Select(M m, F a, F b) { return _mm256_blendv_ps(b, a, m); }
+    static M And(M a, M b) { return _mm256_and_ps(a, b); }
+    static M Or(M a, M b) { return _mm256_or_ps(a, b); }
+    static int Bits(M m) { return _mm256_movemask_ps(m); }
+    static M HasFlag(I flags, int flag) {
+        __m256i bit = _mm256_set1_epi32(flag);
+        return _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(flags, bit), bit));
+    }
+};
+typedef AVX2Lanes VectorLanes;
+#endif
+
+#if !defined(ENEMY_SSE2) && !defined(ENEMY_AVX2)
+typedef ScalarLanes VectorLanes;
+#endif
+
+const int Enemies::LANES = VectorLanes::WIDTH;
+
+const char* Enemies::KernelName() {
+#if defined(ENEMY_AVX2)
+    return "AVX2";
+#elif defined(ENEMY_SSE2)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+// what Entity::Update works out for a step of one length
+struct StepRate {
+    float elapsed;
+    // lerp's (1 - t) and t * 0 for the x and y friction
+    float keepX;
+    float dropX;
+    float keepY;
+    float dropY;
+    float fall;
+};
+
+static StepRate MakeRate(float elapsed) {
+    const Entity defaults;
+    float frictionX = elapsed * defaults.fricX;
+    float frictionY = elapsed * defaults.fricY;
+    StepRate rate;
+    rate.elapsed = elapsed;
+    rate.keepX = 1.0f - frictionX;
+    rate.dropX = frictionX * 0.0f;
+    rate.keepY = 1.0f - frictionY;
+    rate.dropY = frictionY * 0.0f;
+    rate.fall = defaults.gravityY * elapsed;
+    return rate;
+}
+
+// per step values shared by every enemy
+struct StepConstants {
+    // for enemies near the target, and the longer steps of those further out
+    StepRate fine;
+    StepRate coarse;
+    float targetX;
+    // enemies within nearRange of targetX step every time, the rest within
+    // coarseRange only when coarseDue
+    float nearRange;
+    float coarseRange;
+    bool coarseDue;
+    // awake enemies left of sleepLeft or below sleepBelow go to sleep
+    float sleepLeft;
+    float sleepBelow;
+};
+
+// Entity::Update for WIDTH enemies from first, returns a bit for each lane
+// that should go to sleep. The integration runs across the lanes, the tile
+// sweep walks a different run of tiles for each so it runs lane by lane
+template <typename V>
+static int StepLanes(Enemies& e, int first, const StepConstants& c, const FlareMap& map) {
+    typedef typename V::F F;
+    typedef typename V::M M;
+
+    M awake = V::HasFlag(V::LoadInt(&e.flags[first]), ENEMY_AWAKE);
+    F x = V::Load(&e.x[first]);
+    F target = V::Set(c.targetX);
+    F distance = V::Abs(V::Sub(x, target));
+    M near = V::Less(distance, V::Set(c.nearRange));
+    M run = V::And(awake, c.coarseDue ? V::Or(near, V::Less(distance, V::Set(c.coarseRange))) : near);
+    if (V::Bits(run) == 0) {
+        return 0;
+    }
+    F y = V::Load(&e.y[first]);
+    F velX = V::Load(&e.velX[first]);
+    F velY = V::Load(&e.velY[first]);
+    F accX = V::Load(&e.accX[first]);
+    F zero = V::Set(0.0f);
+    F elapsed = V::Select(near, V::Set(c.fine.elapsed), V::Set(c.coarse.elapsed));
+
+    // chase
+    velX = V::Select(V::Less(V::Sub(x, target), zero), V::Set(CHASE_SPEED), V::Set(-CHASE_SPEED));
+
+    // integrate
+    F keepX = V::Select(near, V::Set(c.fine.keepX), V::Set(c.coarse.keepX));
+    F dropX = V::Select(near, V::Set(c.fine.dropX), V::Set(c.coarse.dropX));
+    F keepY = V::Select(near, V::Set(c.fine.keepY), V::Set(c.coarse.keepY));
+    F dropY = V::Select(near, V::Set(c.fine.dropY), V::Set(c.coarse.dropY));
+    F fall = V::Select(near, V::Set(c.fine.fall), V::Set(c.coarse.fall));
+    velX = V::Add(V::Mul(keepX, velX), dropX);
+    velY = V::Add(V::Mul(keepY, velY), dropY);
+    velX = V::Add(velX, V::Mul(accX, elapsed));
+    velY = V::Add(velY, fall);
+    float moveX[V::WIDTH];
+    float moveY[V::WIDTH];
+    V::Store(moveX, V::Mul(velX, elapsed));
+    V::Store(moveY, V::Mul(velY, elapsed));
+
+    // sleepers and enemies sitting this step out keep everything
+    V::Store(&e.prevX[first], V::Select(run, x, V::Load(&e.prevX[first])));
+    V::Store(&e.prevY[first], V::Select(run, y, V::Load(&e.prevY[first])));
+    V::Store(&e.velX[first], V::Select(run, velX, V::Load(&e.velX[first])));
+    V::Store(&e.velY[first], V::Select(run, velY, V::Load(&e.velY[first])));
+
+    int bits = V::Bits(run);
+    for (int lane = 0; lane < V::WIDTH; lane++) {
+        if (!((bits >> lane) & 1)) {
+            continue;
+        }
+        int i = first + lane;
+        TileSweep sweep = SweepTiles(map, e.x[i], e.y[i], e.width[i], e.height[i], moveX[lane], moveY[lane]);
+        if (sweep.normalY) {
+            e.velY[i] = 0.0f;
+        }
+        if (sweep.normalX) {
+            e.velX[i] = 0.0f;
+            e.accX[i] = 0.0f;
+        }
+    }
+
+    x = V::Load(&e.x[first]);
+    y = V::Load(&e.y[first]);
+    M left = V::Or(V::Less(x, V::Set(c.sleepLeft)), V::Less(y, V::Set(c.sleepBelow)));
+    return V::Bits(V::And(run, left));
+}
+
+void Enemies::Clear() {
+    count = 0;
+    Resize(0);
+    for (std::vector<int>& bucket : sleepers) {
+        bucket.clear();
+    }
+    awakeGroups.clear();
+    slept.clear();
+}
+
+void Enemies::Reserve(int capacity) {
+    int padded = capacity + LANES;
+    for (std::vector<float>* column : { &x, &y, &prevX, &prevY, &velX, &velY, &accX, &width, &height }) {
+        column->reserve(padded);
+    }
+    flags.reserve(padded);
+    spriteIndex.reserve(padded);
+}
+
+void Enemies::Resize(int size) {
+    // padding lanes are zeroed sleepers, far enough away to never wake
+    int padded = (size + LANES - 1) / LANES * LANES;
+    for (std::vector<float>* column : { &y, &prevX, &prevY, &velX, &velY, &accX, &width, &height }) {
+        column->resize(padded, 0.0f);
+    }
+    x.resize(padded, -1.0e30f);
+    flags.resize(padded, 0);
+    spriteIndex.resize(padded, 0);
+    awakeInGroup.resize(padded / LANES, 0);
+    groupSlot.resize(padded / LANES, -1);
+}
+
+int Enemies::Add(float x_, float y_, float width_, float height_) {
+    int i = count++;
+    Resize(count);
+    x[i] = prevX[i] = x_;
+    y[i] = prevY[i] = y_;
+    velX[i] = velY[i] = accX[i] = 0.0f;
+    width[i] = width_;
+    height[i] = height_;
+    flags[i] = 0;
+    spriteIndex[i] = 0;
+    Bucket(x_).push_back(i);
+    return i;
+}
+
+std::vector<int>& Enemies::Bucket(float x_) {
+    if (sleepers.empty()) {
+        sleepers.resize(SLEEP_BUCKETS);
+    }
+    // clamped so far off columns still convert to an int
+    float column = floorf(std::min(std::max(x_ / TILE_SIZE, -1.0e9f), 1.0e9f));
+    return sleepers[(int)column & (SLEEP_BUCKETS - 1)];
+}
+
+void Enemies::SetAwake(int i) {
+    flags[i] |= ENEMY_AWAKE;
+    int group = i / LANES;
+    if (awakeInGroup[group]++ == 0) {
+        groupSlot[group] = (int)awakeGroups.size();
+        awakeGroups.push_back(group);
+    }
+}
+
+void Enemies::Wake(int i) {
+    if (Awake(i)) {
+        return;
+    }
+    std::vector<int>& bucket = Bucket(x[i]);
+    bucket.erase(std::find(bucket.begin(), bucket.end(), i));
+    SetAwake(i);
+}
+
+void Enemies::Sleep(int i) {
+    flags[i] &= ~ENEMY_AWAKE;
+    Bucket(x[i]).push_back(i);
+    int group = i / LANES;
+    if (--awakeInGroup[group] == 0) {
+        int slot = groupSlot[group];
+        awakeGroups[slot] = awakeGroups.back();
+        groupSlot[awakeGroups[slot]] = slot;
+        awakeGroups.pop_back();
+        groupSlot[group] = -1;
+    }
+}
+
+void Enemies::WakeNear(float targetX) {
+    if (sleepers.empty()) {
+        return;
+    }
+    // a tile either side can only reach the next column over, two more
+    // cover the rounding of the divide
+    float column = floorf(std::min(std::max(targetX / TILE_SIZE, -1.0e9f), 1.0e9f));
+    for (int offset = -2; offset <= 2; offset++) {
+        std::vector<int>& bucket = sleepers[((int)column + offset) & (SLEEP_BUCKETS - 1)];
+        for (size_t j = 0; j < bucket.size();) {
+            int i = bucket[j];
+            if (fabsf(x[i] - targetX) < TILE_SIZE) {
+                bucket[j] = bucket.back();
+                bucket.pop_back();
+                SetAwake(i);
+                continue;
+            }
+            j++;
+        }
+    }
+}
+
+void Enemies::Step(float elapsed, float targetX, const FlareMap& map) {
+    StepConstants c;
+    c.fine = MakeRate(elapsed);
+    c.coarse = MakeRate(elapsed * COARSE_INTERVAL);
+    c.targetX = targetX;
+    float never = -std::numeric_limits<float>::infinity();
+    c.nearRange = levelOfDetail ? NEAR_RANGE : -never;
+    c.coarseRange = COARSE_RANGE;
+    c.sleepLeft = sleepWhenLeftBehind ? targetX - SLEEP_BEHIND : never;
+    c.sleepBelow = sleepWhenLeftBehind ? -map.mapData.Height() * TILE_SIZE - SLEEP_BELOW : never;
+
+    slept.clear();
+    if (map.mapData.Width() == 0 || map.mapData.Height() == 0) {
+        return;
+    }
+    stepCount++;
+    for (int group : awakeGroups) {
+        // a different quarter of the groups takes its coarse step each time
+        c.coarseDue = (stepCount + group) % COARSE_INTERVAL == 0;
+        int first = group * LANES;
+        int sleep = StepLanes<VectorLanes>(*this, first, c, map);
+        for (int lane = 0; sleep != 0; lane++, sleep >>= 1) {
+            if (sleep & 1) {
+                slept.push_back(first + lane);
+            }
+        }
+    }
+    // after the loop, sleeping can reorder awakeGroups
+    for (int i : slept) {
+        Sleep(i);
+    }
+    // woken after moving, like the old per entity check
+    WakeNear(targetX);
+}
+
+void Enemies::Animate() {
+    int frames = (int)GetClip(CLIP_ENEMY).frames.size();
+    ForEachAwake([&](int i) {
+        if (++spriteIndex[i] >= frames) {
+            spriteIndex[i] = 0;
+        }
+    });
+}
+
+bool Enemies::CollidesWith(int i, const Entity& entity) const {
+    float x_dist = fabs(x[i] - entity.x) - ((width[i] * 0.5f) + (entity.width * 0.5f));
+    float y_dist = fabs(y[i] - entity.y) - ((height[i] * 0.5f) + (entity.height * 0.5f));
+    return (x_dist <= 0 && y_dist <= 0);
+}
+
+Entity Enemies::Body(int i) const {
+    Entity body(x[i], y[i], width[i], height[i], !Awake(i));
+    body.prevX = prevX[i];
+    body.prevY = prevY[i];
+    body.velX = velX[i];
+    body.velY = velY[i];
+    body.accX = accX[i];
+    body.spriteIndex = spriteIndex[i];
+    body.SetClip(CLIP_ENEMY);
+    return body;
+}
@@ -0,0 +1,113 @@
+#ifndef ENEMIES_H
+#define ENEMIES_H
+
+#include "FlareMap.h"
+#include "Entity.h"
+#include <algorithm>
+#include <vector>
+
+enum EnemyFlag { ENEMY_AWAKE = 1 };
+
+// The level's enemies as a structure of arrays, one column per field, so a
+// step runs over packed floats a SIMD register at a time: 8 enemies with
+// AVX2, 4 with SSE2, one by one where neither is available. The columns are
+// padded to whole registers with sleeping enemies that are never touched.
+//
+// A step does exactly what Entity::Update and checkTileCollision do for
+// each enemy near the target, in the same order and float precision, so the
+// game plays out the same where it can be seen. Enemies further out step
+// less often with longer steps, and the furthest not at all. The collision
+// flags Entity keeps aren't stored since nothing reads them for enemies.
+//
+// Only registers holding an awake enemy are stepped. Sleeping enemies don't
+// move, so they wait in buckets by tile column and a step only looks at the
+// few columns around the target to wake them. That keeps a step's cost down
+// to the enemies that are around the player, however big the level.
+class Enemies {
+public:
+	// enemies handled per kernel call on this build
+	static const int LANES;
+
+	void Clear();
+	void Reserve(int capacity);
+
+	// a sleeping enemy centred on (x, y), returns its index
+	int Add(float x, float y, float width, float height);
+
+	int Count() const { return count; }
+	bool Awake(int i) const { return (flags[i] & ENEMY_AWAKE) != 0; }
+
+	// wakes enemy i, it moves from the next Step on
+	void Wake(int i);
+
+	// one step: awake enemies turn towards targetX, fall and collide with the
+	// map's tiles, sleeping ones within a tile of targetX wake for the next
+	// step. Awake ones left far behind targetX or knocked out below the level
+	// go back to sleep, unless sleepWhenLeftBehind is off
+	void Step(float elapsed, float targetX, const FlareMap& map);
+
+	// calls f(i) for every awake enemy, in no particular order
+	template <typename F>
+	void ForEachAwake(F f) const {
+		for (int group : awakeGroups) {
+			int end = std::min((group + 1) * LANES, count);
+			for (int i = group * LANES; i < end; i++) {
+				if (Awake(i)) {
+					f(i);
+				}
+			}
+		}
+	}
+
+	// the enemies the last Step put back to sleep
+	const std::vector<int>& Slept() const { return slept; }
+
+	bool sleepWhenLeftBehind = true;
+	// when off every awake enemy takes every step in full, see NEAR_RANGE
+	bool levelOfDetail = true;
+
+	// moves every awake enemy's animation on a frame
+	void Animate();
+
+	// the same test as Entity::CollidesWith
+	bool CollidesWith(int i, const Entity& entity) const;
+
+	// the enemy as an Entity, e.g. to draw it
+	Entity Body(int i) const;
+
+	// "AVX2", "SSE2" or "scalar"
+	static const char* KernelName();
+
+	std::vector<float> x;
+	std::vector<float> y;
+	std::vector<float> prevX;
+	std::vector<float> prevY;
+	std::vector<float> velX;
+	std::vector<float> velY;
+	std::vector<float> accX;
+	std::vector<float> width;
+	std::vector<float> height;
+	std::vector<int> flags;
+	std::vector<int> spriteIndex;
+
+private:
+	void Resize(int size);
+	void Sleep(int i);
+	void WakeNear(float targetX);
+	// sets i's flag and counts it in its group, the caller takes it out of its bucket
+	void SetAwake(int i);
+	std::vector<int>& Bucket(float x);
+
+	int count = 0;
+	// sleeping enemies by tile column, columns SLEEP_BUCKETS apart share one
+	std::vector<std::vector<int>> sleepers;
+	// per register group, how many of its enemies are awake
+	std::vector<int> awakeInGroup;
+	// the groups with an awake enemy, and each group's place in that list (-1 if none)
+	std::vector<int> awakeGroups;
+	std::vector<int> groupSlot;
+	std::vector<int> slept;
+	unsigned int stepCount = 0;
+};
+
+#endif
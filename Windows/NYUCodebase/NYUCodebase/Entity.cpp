@@ -1,74 +1,40 @@
 #include "Entity.h"
 #include "helper.h"
-#include "glm/mat4x4.hpp"
-#include "glm/gtc/matrix_transform.hpp"
-#include <algorithm>
+#include "TileSweep.h"
+#include <math.h>
 
 Entity::Entity() {}
 
 Entity::Entity(float x_, float y_, float width_, float height_, bool isStatic_) {
     x = x_;
     y = y_;
+    prevX = x_;
+    prevY = y_;
     width = width_;
     height = height_;
     isStatic = isStatic_;
 }
 
-void Entity::Render(ShaderProgram& p) {
-    glm::mat4 modelMatrix = glm::mat4(1.0f);
-    modelMatrix = glm::translate(modelMatrix, glm::vec3(x, y, 0.0f));
-    p.SetModelMatrix(modelMatrix);
-    float u; 
-    float v;
-    if (spriteSet == 0) {
-        u = (float)(((int)sprites[spriteIndex]) % sheet.spriteCountX) / (float)sheet.spriteCountX;
-        v = (float)(((int)sprites[spriteIndex]) / sheet.spriteCountX) / (float)sheet.spriteCountY;
+void Entity::SetClips(AnimationClipID standing, AnimationClipID left, AnimationClipID right) {
+    clips[0] = standing;
+    clips[1] = left;
+    clips[2] = right;
+}
 
-    }
-    else if (spriteSet == 1) {
-        u = (float)(((int)forwardSprites[spriteIndex]) % sheet.spriteCountX) / (float)sheet.spriteCountX;
-        v = (float)(((int)forwardSprites[spriteIndex]) / sheet.spriteCountX) / (float)sheet.spriteCountY;
+void Entity::SetClip(AnimationClipID clip) {
+    SetClips(clip, clip, clip);
+}
 
-    }		
-    else if (spriteSet == 2) {
-        u = (float)(((int)backwardSprites[spriteIndex]) % sheet.spriteCountX) / (float)sheet.spriteCountX;
-        v = (float)(((int)backwardSprites[spriteIndex]) / sheet.spriteCountX) / (float)sheet.spriteCountY;
+void Entity::NextFrame() {
+    spriteIndex++;
+    if (spriteIndex >= (int)GetClip(CurrentClip()).frames.size()) {
+        spriteIndex = 0;
     }
-
-    float spriteWidth = 1.0f / (float)sheet.spriteCountX;
-    float spriteHeight = 1.0f / (float)sheet.spriteCountY;
-    GLfloat texCoords[] = {
-        u, v + spriteHeight,
-        u + spriteWidth, v,
-        u, v,
-        u + spriteWidth, v,
-        u, v + spriteHeight,
-        u + spriteWidth, v + spriteHeight
-    };
-    float aspect = width / height;
-    float vertices[] = {
-        -0.5f * aspect * TILE_SIZE, -0.5f * TILE_SIZE,
-        0.5f * aspect * TILE_SIZE, 0.5f * TILE_SIZE,
-        -0.5f * aspect * TILE_SIZE, 0.5f * TILE_SIZE,
-        0.5f * aspect * TILE_SIZE, 0.5f * TILE_SIZE,
-        -0.5f * aspect * TILE_SIZE, -0.5f * TILE_SIZE,
-        0.5f * aspect * TILE_SIZE, -0.5f * TILE_SIZE
-    };
-
-    glBindTexture(GL_TEXTURE_2D, sheet.textureID);
-
-    glVertexAttribPointer(p.positionAttribute, 2, GL_FLOAT, false, 0, vertices);
-    glEnableVertexAttribArray(p.positionAttribute);
-    glVertexAttribPointer(p.texCoordAttribute, 2, GL_FLOAT, false, 0, texCoords);
-    glEnableVertexAttribArray(p.texCoordAttribute);
-
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-
-    glDisableVertexAttribArray(p.positionAttribute);
-    glDisableVertexAttribArray(p.texCoordAttribute);
 }
 
 bool Entity::Update(float elapsed, FlareMap* map) {
+    prevX = x;
+    prevY = y;
     if (!isStatic) {
         collidedBottom = collidedTop = dangerCollide = false;
         wallJumpFrames += elapsed;
@@ -83,9 +49,7 @@ bool Entity::Update(float elapsed, FlareMap* map) {
         velX += accX * elapsed;
         velY += gravityY * elapsed;
 
-        x += velX * elapsed;
-        y += velY * elapsed;
-        return checkTileCollision(map);
+        return checkTileCollision(map, velX * elapsed, velY * elapsed);
     }
     return false; 
 }
@@ -118,80 +82,32 @@ bool Entity::CollidesWith(Entity& entity) {
     return (x_dist <= 0 && y_dist <= 0);
 }
 
-bool Entity::checkTileCollision(FlareMap *map) {
+bool Entity::checkTileCollision(FlareMap *map, float dx, float dy) {
+    TileSweep sweep = SweepTiles(*map, x, y, width, height, dx, dy);
+    if (sweep.normalY) {
+        (sweep.normalY > 0 ? collidedBottom : collidedTop) = true;
+        velY = 0.0f;
+        accY = 0.0f;
+    }
+    if (sweep.normalX) {
+        if (sweep.flagsX & TILE_WALL_JUMP) {
+            wallJump = true;
+            wallJumpFrames += 0.001f;
+        }
+        (sweep.normalX > 0 ? collidedLeft : collidedRight) = true;
+        velX = 0.0f;
+        accX = 0.0f;
+    }
+    // only the middle of each face is dangerous, the way the old point
+    // probes were, so clipping a spike with a corner isn't fatal
+    dangerCollide = (TilesAtFaces(*map, x, y, width, height) & TILE_DANGER) != 0;
 
+    // falling out of the level is as bad as a danger tile
     int gridX;
     int gridY;
-
-    //bottom
     worldToTileCoordinates(x, y - 0.5f * height, &gridX, &gridY);
-    if (gridX >= 0 && gridX < map->mapWidth && gridY >= 0 && gridY < map->mapHeight) {
-        if (std::find(solidTiles.begin(), solidTiles.end(), map->mapData[gridY][gridX]) != solidTiles.end()) {
-            collidedBottom = true;
-            velY = 0.0f;
-            accY = 0.0f;
-            float penetration = fabs((-TILE_SIZE * gridY) - (y - height / 2));
-            y += penetration + (TILE_SIZE * 0.00000000001f);
-        }
-        if (std::find(dangerTiles.begin(), dangerTiles.end(), map->mapData[gridY][gridX]) != dangerTiles.end()) {
-            dangerCollide = true;
-        }
-    }
-    else {
+    if (!map->mapData.InBounds(gridX, gridY)) {
         return true;
     }
-
-    //top
-    worldToTileCoordinates(x, y + 0.5f * height, &gridX, &gridY);
-    if (gridX >= 0 && gridX < map->mapWidth && gridY >= 0 && gridY < map->mapHeight) {
-        if (std::find(solidTiles.begin(), solidTiles.end(), map->mapData[gridY][gridX]) != solidTiles.end()) {
-            collidedTop = true;
-            velY = 0.0f;
-            accY = 0.0f;
-            float penetration = fabs(((-TILE_SIZE * gridY) - TILE_SIZE) - (y + height / 2));
-            y -= penetration + (TILE_SIZE * 0.00000000001f);
-        }
-        if (std::find(dangerTiles.begin(), dangerTiles.end(), map->mapData[gridY][gridX]) != dangerTiles.end()) {
-            dangerCollide = true;
-        }
-    }
-
-    //left
-    worldToTileCoordinates(x - 0.5f * width, y, &gridX, &gridY);
-    if (gridX >= 0 && gridX < map->mapWidth && gridY >= 0 && gridY < map->mapHeight) {
-        if (std::find(solidTiles.begin(), solidTiles.end(), map->mapData[gridY][gridX]) != solidTiles.end()) {
-            if (map->mapData[gridY][gridX] == 6) {
-                wallJump = true;
-                wallJumpFrames += 0.001f;
-            }
-            collidedLeft = true;
-            velX = 0.0f;
-            accX = 0.0f;
-            float penetration = fabs(((TILE_SIZE * gridX) + TILE_SIZE) - (x - width / 2));
-            x += penetration + (TILE_SIZE * 0.00000000001f);
-        }
-        if (std::find(dangerTiles.begin(), dangerTiles.end(), map->mapData[gridY][gridX]) != dangerTiles.end()) {
-            dangerCollide = true;
-        }
-    }
-
-    //right
-    worldToTileCoordinates(x + 0.5f * width, y, &gridX, &gridY);
-    if (gridX >= 0 && gridX < map->mapWidth && gridY >= 0 && gridY < map->mapHeight) {
-        if (std::find(solidTiles.begin(), solidTiles.end(), map->mapData[gridY][gridX]) != solidTiles.end()) {
-            if (map->mapData[gridY][gridX] == 6) {
-                wallJump = true;
-                wallJumpFrames += 0.001f;
-            }
-            collidedRight = true;
-            velX = 0.0f;
-            accX = 0.0f;
-            float penetration = fabs((TILE_SIZE * gridX) - (x + width / 2));
-            x -= penetration + (TILE_SIZE * 0.00000000001f);
-        }
-        if (std::find(dangerTiles.begin(), dangerTiles.end(), map->mapData[gridY][gridX]) != dangerTiles.end()) {
-            dangerCollide = true;
-        }
-    }
     return dangerCollide;
-}
\ No newline at end of file
+}
@@ -1,10 +1,9 @@
 #ifndef ENTITY_H
 #define ENTITY_H
 
-#include "SpriteSheet.h"
 #include "FlareMap.h"
-#include "ShaderProgram.h"
-#include <vector>
+#include "Animation.h"
+#include <type_traits>
 
 class Entity {
 public:
@@ -13,6 +12,8 @@ public:
 
 	float x = 0.0f;
 	float y = 0.0f;
+	float prevX = 0.0f;
+	float prevY = 0.0f;
 	float width;
 	float height;
 	float velX = 0.0f;
@@ -23,12 +24,9 @@ public:
 	float fricY = 0.0f;
 	float gravityY = -2.2f;
 
-	SpriteSheet sheet;
-
-	std::vector<int> sprites;
-	std::vector<int> forwardSprites;
-	std::vector<int> backwardSprites;
-	int spriteIndex;
+	// the clip shown for each spriteSet, 0 standing, 1 moving left, 2 moving right
+	AnimationClipID clips[3] = { CLIP_ENEMY, CLIP_ENEMY, CLIP_ENEMY };
+	int spriteIndex = 0;
 	int spriteSet = 0; 
     
 	float wallJumpFrames = 0.0f;
@@ -40,17 +38,31 @@ public:
 	bool wallJump = false;
 	bool isStatic = true;
 
-	void Render(ShaderProgram& p);
-
 	bool Update(float elapsed, FlareMap* map);
 
+	void SetClips(AnimationClipID standing, AnimationClipID left, AnimationClipID right);
+
+	// the same clip whichever way the entity moves
+	void SetClip(AnimationClipID clip);
+
+	AnimationClipID CurrentClip() const { return clips[spriteSet]; }
+
+	// steps spriteIndex on, looping at the end of the current clip
+	void NextFrame();
+
 	void resolveCollisionX(Entity& entity);
 
 	void resolveCollisionY(Entity& entity);
 
 	bool CollidesWith(Entity& entity);
 
-	bool checkTileCollision(FlareMap *map);
+	// moves by (dx, dy) through the map's tiles, stopping at solid ones.
+	// True if the entity touched a danger tile or fell out of the level
+	bool checkTileCollision(FlareMap *map, float dx, float dy);
 };
 
+// entities are copied and stored by value everywhere, so they stay plain
+// data: animations are shared clips referred to by id, not owned
+static_assert(std::is_trivially_copyable<Entity>::value, "Entity must stay trivially copyable");
+
 #endif 
\ No newline at end of file
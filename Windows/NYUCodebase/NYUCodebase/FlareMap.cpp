@@ -1,96 +1,375 @@
 #include "FlareMap.h"
+#include "MappedFile.h"
+#include "LevelFormat.h"
+#include "helper.h"
 
-#include <fstream>
 #include <string>
-#include <iostream>
-#include <sstream>
-#include <cassert>
+#include <string_view>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+#include <atomic>
+#include <math.h>
+
+// Walks a mapped level file a line at a time. Lines are views into the
+// mapping, nothing is copied.
+struct FlareReader {
+    const std::string& fileName;
+    const char* pos;
+    const char* end;
+    int lineNumber = 0;
+    std::string_view line;
+
+    FlareReader(const std::string& fileName_, const char* begin, const char* end_) :
+        fileName(fileName_), pos(begin), end(end_) {}
+
+    std::string Location() const {
+        return fileName + ":" + std::to_string(lineNumber);
+    }
+
+    bool NextLine() {
+        if (pos >= end) {
+            return false;
+        }
+        const char* lineEnd = (const char*)memchr(pos, '\n', end - pos);
+        const char* next = lineEnd ? lineEnd + 1 : end;
+        if (!lineEnd) {
+            lineEnd = end;
+        }
+        if (lineEnd > pos && lineEnd[-1] == '\r') {
+            lineEnd--;
+        }
+        line = std::string_view(pos, lineEnd - pos);
+        pos = next;
+        lineNumber++;
+        return true;
+    }
+
+    // splits the current "key=value" line
+    void KeyValue(std::string_view& key, std::string_view& value) const {
+        size_t equals = line.find('=');
+        key = line.substr(0, equals);
+        value = equals == std::string_view::npos ? std::string_view() : line.substr(equals + 1);
+    }
+};
+
+// parses an integer at pos and steps over it and one following separator
+template <typename T>
+static bool ReadNumber(const char*& pos, const char* end, T& value, char separator = ',') {
+    std::from_chars_result result = std::from_chars(pos, end, value);
+    if (result.ec != std::errc()) {
+        return false;
+    }
+    pos = result.ptr;
+    if (pos < end && *pos == separator) {
+        pos++;
+    }
+    return true;
+}
 
 FlareMap::FlareMap(float tileSize_) {
-		mapData = nullptr;
 		mapWidth = -1;
 		mapHeight = -1;
 		tileSize = tileSize_;
 }
 
-FlareMap::~FlareMap() {
-    for (int i = 0; i < mapHeight; i++) {
-        delete mapData[i];
+bool FlareMap::Load(const std::string fileName) {
+    // read into a fresh map and taken only once it's complete, so a failed
+    // load doesn't leave this one half overwritten
+    FlareMap loaded(tileSize);
+    if (!loaded.Read(fileName)) {
+        loadError = loaded.loadError;
+        return false;
     }
-    delete mapData;
+    loadError.clear();
+    mapWidth = loaded.mapWidth;
+    mapHeight = loaded.mapHeight;
+    mapData.Swap(loaded.mapData);
+    entities.swap(loaded.entities);
+    entityTypes.swap(loaded.entityTypes);
+    tileFlags.swap(loaded.tileFlags);
+    chunkSummaries.swap(loaded.chunkSummaries);
+    mapping.swap(loaded.mapping);
+    return true;
 }
 
-void FlareMap::Load(const std::string fileName) {
-    std::ifstream infile(fileName);
-    if (infile.fail()) {
-        assert(false); // unable to open file
+bool FlareMap::Read(const std::string &fileName) {
+    std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>();
+    if (!file->Open(fileName)) {
+        return Fail(fileName, "unable to open file");
+    }
+    if (file->Size() >= 4 && memcmp(file->Data(), BINARY_LEVEL_MAGIC, 4) == 0) {
+        return LoadBinary(fileName, file);
     }
-    std::string line;
-    while (std::getline(infile, line)) {
-        if (line == "[header]") {
-            if (!ReadHeader(infile)) {
-                assert(false); // invalid file data
+    FlareReader reader(fileName, file->Data(), file->Data() + file->Size());
+    while (reader.NextLine()) {
+        if (reader.line == "[header]") {
+            if (!ReadHeader(reader)) {
+                return false;
             }
         }
-        else if (line == "[layer]") {
-            ReadLayerData(infile);
+        else if (reader.line == "[layer]") {
+            if (!ReadLayerData(reader)) {
+                return false;
+            }
         }
-        else if (line == "[ObjectsLayer]") {
-            ReadEntityData(infile);
+        else if (reader.line == "[ObjectsLayer]") {
+            if (!ReadEntityData(reader)) {
+                return false;
+            }
         }
     }
+    if (mapWidth == -1 || mapHeight == -1) {
+        return Fail(reader.Location(), "no [header] section");
+    }
+    BuildTileFlags();
+    chunkSummaries.assign(mapData.ChunksX() * mapData.ChunksY(), ChunkSummary());
+    for (int cy = 0; cy < mapData.ChunksY(); cy++) {
+        for (int cx = 0; cx < mapData.ChunksX(); cx++) {
+            BuildChunkSummary(cx, cy);
+        }
+    }
+    return true;
 }
 
-bool FlareMap::ReadHeader(std::ifstream &stream) {
-    std::string line;
+bool FlareMap::Fail(const std::string &location, const std::string &message) {
+    loadError = location + ": " + message;
+    return false;
+}
+
+// pads the output to the 16 byte boundary every section starts on
+static uint32_t AlignSection(std::ofstream &out) {
+    static const char zeros[16] = {};
+    uint32_t offset = (uint32_t)out.tellp();
+    uint32_t aligned = (offset + 15) & ~15u;
+    out.write(zeros, aligned - offset);
+    return aligned;
+}
+
+bool FlareMap::SaveBinary(const std::string fileName) const {
+    std::ofstream out(fileName, std::ios::binary);
+    if (out.fail()) {
+        return false;
+    }
+    BinaryLevelHeader header = {};
+    memcpy(header.magic, BINARY_LEVEL_MAGIC, 4);
+    header.version = BINARY_LEVEL_VERSION;
+    header.mapWidth = mapWidth;
+    header.mapHeight = mapHeight;
+    header.chunkShift = TileGrid<TileID>::SHIFT;
+    header.tileIdBytes = sizeof(TileID);
+    out.write((const char*)&header, sizeof(header));
+
+    header.tileOffset = AlignSection(out);
+    header.tileCount = (uint32_t)mapData.CellCount();
+    out.write((const char*)mapData.Data(), mapData.CellCount() * sizeof(TileID));
+
+    header.flagOffset = AlignSection(out);
+    header.flagCount = (uint32_t)tileFlags.size();
+    out.write((const char*)tileFlags.data(), tileFlags.size());
+
+    header.summaryOffset = AlignSection(out);
+    header.summaryCount = (uint32_t)chunkSummaries.size();
+    for (const ChunkSummary& summary : chunkSummaries) {
+        BinaryChunkSummary entry = { summary.tileCount, summary.flags, 0 };
+        out.write((const char*)&entry, sizeof(entry));
+    }
+
+    header.typeOffset = AlignSection(out);
+    for (const std::string& type : entityTypes) {
+        out.write(type.c_str(), type.size() + 1);
+        header.typeBytes += (uint32_t)type.size() + 1;
+    }
+
+    header.entityOffset = AlignSection(out);
+    header.entityCount = (uint32_t)entities.size();
+    for (const FlareMapEntity& entity : entities) {
+        BinaryLevelEntity entry = { (uint32_t)entity.type, entity.x, entity.y };
+        out.write((const char*)&entry, sizeof(entry));
+    }
+
+    out.seekp(0);
+    out.write((const char*)&header, sizeof(header));
+    return !out.fail();
+}
+
+bool FlareMap::LoadBinary(const std::string &fileName, const std::shared_ptr<MappedFile> &file) {
+    char* base = file->Data();
+    size_t size = file->Size();
+    BinaryLevelHeader header;
+    if (size < sizeof(header)) {
+        return Fail(fileName, "compiled level is truncated");
+    }
+    memcpy(&header, base, sizeof(header));
+    if (header.version != BINARY_LEVEL_VERSION) {
+        return Fail(fileName, "compiled level is version " + std::to_string(header.version) +
+            ", expected " + std::to_string(BINARY_LEVEL_VERSION) + "; rebuild it with flare2oofl");
+    }
+    if (header.chunkShift != TileGrid<TileID>::SHIFT || header.tileIdBytes != sizeof(TileID)) {
+        return Fail(fileName, "compiled level uses a different tile grid layout; rebuild it with flare2oofl");
+    }
+
+    auto fits = [size](uint32_t offset, uint64_t bytes) { return offset % 16 == 0 && offset + bytes <= size; };
+    mapWidth = header.mapWidth;
+    mapHeight = header.mapHeight;
+    TileGrid<TileID> grid;
+    grid.Attach(nullptr, mapWidth, mapHeight);
+    if (mapWidth <= 0 || mapHeight <= 0 || header.tileCount != grid.CellCount() ||
+        header.summaryCount != (uint32_t)(grid.ChunksX() * grid.ChunksY()) ||
+        !fits(header.tileOffset, (uint64_t)header.tileCount * sizeof(TileID)) ||
+        !fits(header.flagOffset, header.flagCount) ||
+        !fits(header.summaryOffset, (uint64_t)header.summaryCount * sizeof(BinaryChunkSummary)) ||
+        !fits(header.typeOffset, header.typeBytes) ||
+        !fits(header.entityOffset, (uint64_t)header.entityCount * sizeof(BinaryLevelEntity))) {
+        return Fail(fileName, "compiled level is damaged");
+    }
+
+    // the tiles are used where they are mapped, everything else is small enough to copy
+    mapData.Attach((TileID*)(base + header.tileOffset), mapWidth, mapHeight);
+    // the flags come from the tile lists in helper.cpp, which may have
+    // changed since the level was compiled, so they're rebuilt for the ids
+    // the level uses and the stored ones only tell whether they still hold
+    const unsigned char* flags = (const unsigned char*)(base + header.flagOffset);
+    AssignTileFlags(header.flagCount);
+    bool rulesChanged = !std::equal(tileFlags.begin(), tileFlags.end(), flags);
+
+    const BinaryChunkSummary* summaries = (const BinaryChunkSummary*)(base + header.summaryOffset);
+    chunkSummaries.resize(header.summaryCount);
+    for (uint32_t i = 0; i < header.summaryCount; i++) {
+        chunkSummaries[i].tileCount = summaries[i].tileCount;
+        chunkSummaries[i].flags = summaries[i].flags;
+        chunkSummaries[i].revision = NextRevision();
+    }
+    if (rulesChanged) {
+        for (int cy = 0; cy < mapData.ChunksY(); cy++) {
+            for (int cx = 0; cx < mapData.ChunksX(); cx++) {
+                BuildChunkSummary(cx, cy);
+            }
+        }
+    }
+
+    const char* type = base + header.typeOffset;
+    const char* typesEnd = type + header.typeBytes;
+    while (type < typesEnd) {
+        size_t length = strnlen(type, typesEnd - type);
+        entityTypes.push_back(std::string(type, length));
+        type += length + 1;
+    }
+
+    const BinaryLevelEntity* entries = (const BinaryLevelEntity*)(base + header.entityOffset);
+    for (uint32_t i = 0; i < header.entityCount; i++) {
+        if (entries[i].type >= entityTypes.size()) {
+            return Fail(fileName, "compiled level is damaged");
+        }
+        FlareMapEntity entity;
+        entity.type = (int)entries[i].type;
+        entity.x = entries[i].x;
+        entity.y = entries[i].y;
+        entities.push_back(entity);
+    }
+
+    mapping = file;
+    return true;
+}
+
+unsigned char FlareMap::RegionFlags(int minX, int minY, int maxX, int maxY) const {
+    minX = std::max(minX, 0);
+    minY = std::max(minY, 0);
+    maxX = std::min(maxX, mapWidth - 1);
+    maxY = std::min(maxY, mapHeight - 1);
+    if (minX > maxX || minY > maxY) {
+        return 0;
+    }
+    unsigned char flags = 0;
+    for (int cy = minY / TileGrid<TileID>::CHUNK_SIZE; cy <= maxY / TileGrid<TileID>::CHUNK_SIZE; cy++) {
+        for (int cx = minX / TileGrid<TileID>::CHUNK_SIZE; cx <= maxX / TileGrid<TileID>::CHUNK_SIZE; cx++) {
+            flags |= ChunkAt(cx, cy).flags;
+        }
+    }
+    return flags;
+}
+
+ChunkRange FlareMap::ChunksIn(const WorldRect& rect) const {
+    ChunkRange range;
+    // tile rows count downwards from y = 0
+    int minX = std::max((int)floorf(rect.left / tileSize), 0);
+    int maxX = std::min((int)floorf(rect.right / tileSize), mapWidth - 1);
+    int minY = std::max((int)floorf(-rect.top / tileSize), 0);
+    int maxY = std::min((int)floorf(-rect.bottom / tileSize), mapHeight - 1);
+    if (minX > maxX || minY > maxY) {
+        return range;
+    }
+    range.minX = minX >> TileGrid<TileID>::SHIFT;
+    range.maxX = maxX >> TileGrid<TileID>::SHIFT;
+    range.minY = minY >> TileGrid<TileID>::SHIFT;
+    range.maxY = maxY >> TileGrid<TileID>::SHIFT;
+    return range;
+}
+
+void FlareMap::SetTile(int gridX, int gridY, TileID tile) {
+    if (!mapData.InBounds(gridX, gridY)) {
+        return;
+    }
+    mapData(gridX, gridY) = tile;
+    if (tile != TileGrid<TileID>::EMPTY && tile >= tileFlags.size()) {
+        BuildTileFlags();
+    }
+    BuildChunkSummary(gridX / TileGrid<TileID>::CHUNK_SIZE, gridY / TileGrid<TileID>::CHUNK_SIZE);
+}
+
+bool FlareMap::ReadHeader(FlareReader &reader) {
     mapWidth = -1;
     mapHeight = -1;
-    while (std::getline(stream, line)) {
-        if (line == "") { break; }
-        std::istringstream sStream(line);
-        std::string key, value;
-        std::getline(sStream, key, '=');
-        std::getline(sStream, value);
+    while (reader.NextLine()) {
+        if (reader.line.empty()) { break; }
+        std::string_view key, value;
+        reader.KeyValue(key, value);
+        const char* pos = value.data();
+        const char* end = pos + value.size();
         if (key == "width") {
-            mapWidth = std::atoi(value.c_str());
+            if (!ReadNumber(pos, end, mapWidth)) {
+                return Fail(reader.Location(), "width is not a number");
+            }
         }
         else if (key == "height") {
-            mapHeight = std::atoi(value.c_str());
+            if (!ReadNumber(pos, end, mapHeight)) {
+                return Fail(reader.Location(), "height is not a number");
+            }
         }
     }
-    if (mapWidth == -1 || mapHeight == -1) {
-        return false;
-    }
-    else {
-        mapData = new unsigned int*[mapHeight];
-        for (int i = 0; i < mapHeight; ++i) {
-            mapData[i] = new unsigned int[mapWidth];
-        }
-        return true;
+    if (mapWidth <= 0 || mapHeight <= 0) {
+        return Fail(reader.Location(), "header needs a positive width and height");
     }
+    mapData.Resize(mapWidth, mapHeight);
+    return true;
 }
 
-bool FlareMap::ReadLayerData(std::ifstream &stream) {
-    std::string line;
-    while (getline(stream, line)) {
-        if (line == "") { break; }
-        std::istringstream sStream(line);
-        std::string key, value;
-        std::getline(sStream, key, '=');
-        std::getline(sStream, value);
+bool FlareMap::ReadLayerData(FlareReader &reader) {
+    while (reader.NextLine()) {
+        if (reader.line.empty()) { break; }
+        std::string_view key, value;
+        reader.KeyValue(key, value);
         if (key == "data") {
+            if (mapWidth <= 0) {
+                return Fail(reader.Location(), "layer data before the [header] section");
+            }
             for (int y = 0; y < mapHeight; y++) {
-                getline(stream, line);
-                std::istringstream lineStream(line);
-                std::string tile;
+                if (!reader.NextLine()) {
+                    return Fail(reader.Location(), "layer data ends after " + std::to_string(y) + " rows");
+                }
+                const char* pos = reader.line.data();
+                const char* end = pos + reader.line.size();
                 for (int x = 0; x < mapWidth; x++) {
-                    std::getline(lineStream, tile, ',');
-                    unsigned int val = atoi(tile.c_str());
-                    if (val > 0) {
-                        mapData[y][x] = val - 1;
+                    unsigned int val;
+                    if (!ReadNumber(pos, end, val)) {
+                        return Fail(reader.Location(), "expected " + std::to_string(mapWidth) + " tile ids in the row");
+                    }
+                    if (val > 0 && val - 1 < TileGrid<TileID>::EMPTY) {
+                        mapData(x, y) = val - 1;
                     }
                     else {
-                        mapData[y][x] = -1;
+                        mapData(x, y) = TileGrid<TileID>::EMPTY;
                     }
                 }
             }
@@ -99,30 +378,101 @@ bool FlareMap::ReadLayerData(std::ifstream &stream) {
     return true;
 }
 
-bool FlareMap::ReadEntityData(std::ifstream &stream) {
-    std::string line;
-    std::string type;
-    while (getline(stream, line)) {
-        if (line == "") { break; }
-        std::istringstream sStream(line);
-        std::string key, value;
-        getline(sStream, key, '=');
-        getline(sStream, value);
+bool FlareMap::ReadEntityData(FlareReader &reader) {
+    int type = -1;
+    while (reader.NextLine()) {
+        if (reader.line.empty()) { break; }
+        std::string_view key, value;
+        reader.KeyValue(key, value);
         if (key == "type") {
-            type = value;
+            type = InternEntityType(std::string(value));
         }
         else if (key == "location") {
-            std::istringstream lineStream(value);
-            std::string xPosition, yPosition;
-            getline(lineStream, xPosition, ',');
-            getline(lineStream, yPosition, ',');
+            const char* pos = value.data();
+            const char* end = pos + value.size();
+            int xPosition, yPosition;
+            if (!ReadNumber(pos, end, xPosition) || !ReadNumber(pos, end, yPosition)) {
+                return Fail(reader.Location(), "location needs an x and y position");
+            }
+
+            if (type == -1) {
+                return Fail(reader.Location(), "location before the entity's type");
+            }
 
             FlareMapEntity newEntity;
             newEntity.type = type;
-            newEntity.x = std::atoi(xPosition.c_str()) * tileSize;
-            newEntity.y = std::atoi(yPosition.c_str()) * -tileSize;
+            newEntity.x = xPosition * tileSize;
+            newEntity.y = yPosition * -tileSize;
             entities.push_back(newEntity);
         }
     }
     return true;
+}
+
+void FlareMap::BuildTileFlags() {
+    int maxTile = 0;
+    const TileID* cells = mapData.Data();
+    for (size_t i = 0; i < mapData.CellCount(); i++) {
+        if (cells[i] != TileGrid<TileID>::EMPTY) {
+            maxTile = std::max(maxTile, (int)cells[i]);
+        }
+    }
+    AssignTileFlags(maxTile + 1);
+}
+
+void FlareMap::AssignTileFlags(size_t count) {
+    tileFlags.assign(count, 0);
+
+    struct { std::vector<int>* tiles; unsigned char flag; } properties[] = {
+        { &solidTiles, TILE_SOLID },
+        { &dangerTiles, TILE_DANGER },
+        { &climbTile, TILE_CLIMB },
+        { &wallJumpTiles, TILE_WALL_JUMP },
+    };
+    for (auto& property : properties) {
+        for (int tile : *property.tiles) {
+            if (tile >= 0 && tile < (int)tileFlags.size()) {
+                tileFlags[tile] |= property.flag;
+            }
+        }
+    }
+}
+
+void FlareMap::BuildChunkSummary(int chunkX, int chunkY) {
+    ChunkSummary summary;
+    const TileID* cells = mapData.Chunk(chunkX, chunkY);
+    for (int i = 0; i < TileGrid<TileID>::CHUNK_CELLS; i++) {
+        if (cells[i] != TileGrid<TileID>::EMPTY) {
+            summary.tileCount++;
+            if (cells[i] < tileFlags.size()) {
+                summary.flags |= tileFlags[cells[i]];
+            }
+        }
+    }
+    summary.revision = NextRevision();
+    chunkSummaries[chunkY * mapData.ChunksX() + chunkX] = summary;
+}
+
+unsigned int FlareMap::NextRevision() {
+    // levels are loaded on worker threads
+    static std::atomic<unsigned int> revision(0);
+    return ++revision;
+}
+
+int FlareMap::EntityType(const std::string& name) const {
+    for (size_t i = 0; i < entityTypes.size(); i++) {
+        if (entityTypes[i] == name) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+int FlareMap::InternEntityType(const std::string &name) {
+    int type = EntityType(name);
+    if (type == -1) {
+        entityTypes.push_back(name);
+        type = (int)entityTypes.size() - 1;
+    }
+    return type;
 }
\ No newline at end of file
@@ -1,33 +1,110 @@
 #ifndef FLAREMAP_H
 #define FLAREMAP_H
 
+#include "TileGrid.h"
+#include "helper.h"
+#include <memory>
 #include <string> 
 #include <vector>
 
+// tile ids fit in 16 bits; switch to unsigned char for tilesets of up to 255 tiles
+typedef unsigned short TileID;
+
+// what a chunk of the tile grid holds, so whole chunks can be skipped
+struct ChunkSummary {
+	unsigned short tileCount = 0;
+	unsigned char flags = 0;
+	// changes whenever the chunk is rebuilt and is never reused by another
+	// chunk or level, so a renderer can tell whether its copy is current
+	unsigned int revision = 0;
+
+	bool Empty() const { return tileCount == 0; }
+};
+
+// an inclusive block of chunks, empty when max < min
+struct ChunkRange {
+	int minX = 0;
+	int minY = 0;
+	int maxX = -1;
+	int maxY = -1;
+
+	bool Empty() const { return maxX < minX || maxY < minY; }
+};
+
 struct FlareMapEntity {
-	std::string type;
+	int type;	// index into FlareMap::entityTypes
 	float x;
 	float y;
 };
 
+struct FlareReader;
+class MappedFile;
+
 class FlareMap {
 public:
 	FlareMap(float tileSize_);
-	~FlareMap();
 
-	void Load(const std::string fileName);
+	// Flare text levels and compiled .oofl levels are both accepted, told apart
+	// by their contents. False if the file can't be opened or parsed, see
+	// loadError; the map is then left as it was.
+	bool Load(const std::string fileName);
+
+	// writes the level in the compiled format, see LevelFormat.h
+	bool SaveBinary(const std::string fileName) const;
 
 	int mapWidth;
 	int mapHeight;
 	float tileSize; 
-	unsigned int **mapData;
+	TileGrid<TileID> mapData;
 	std::vector<FlareMapEntity> entities;
+	std::vector<std::string> entityTypes;
+
+	// "file:line: problem" for the last failed Load
+	std::string loadError;
+
+	// TileFlag bits for every tile id used by the level, built on load
+	std::vector<unsigned char> tileFlags;
+
+	// one summary per chunk of mapData, in the grid's chunk order
+	std::vector<ChunkSummary> chunkSummaries;
+
+	// flags of the tile at a grid position, 0 for empty cells
+	unsigned char TileFlags(int gridX, int gridY) const {
+		TileID tile = mapData(gridX, gridY);
+		return tile < tileFlags.size() ? tileFlags[tile] : 0;
+	}
+
+	const ChunkSummary& ChunkAt(int chunkX, int chunkY) const {
+		return chunkSummaries[chunkY * mapData.ChunksX() + chunkX];
+	}
+
+	// union of the tile flags in every chunk touching the given cell rectangle
+	unsigned char RegionFlags(int minX, int minY, int maxX, int maxY) const;
+
+	// chunks that overlap a world rectangle, clamped to the level
+	ChunkRange ChunksIn(const WorldRect& rect) const;
+
+	void SetTile(int gridX, int gridY, TileID tile);
+
+	// index of an entity type name in entityTypes, -1 if no entity has it
+	int EntityType(const std::string& name) const;
 
 private:
+	// keeps a compiled level's mapping alive while mapData points into it
+	std::shared_ptr<MappedFile> mapping;
 
-	bool ReadHeader(std::ifstream &stream);
-	bool ReadLayerData(std::ifstream &stream);
-	bool ReadEntityData(std::ifstream &stream);
+	bool Read(const std::string &fileName);
+	bool ReadHeader(FlareReader &reader);
+	bool ReadLayerData(FlareReader &reader);
+	bool ReadEntityData(FlareReader &reader);
+	bool LoadBinary(const std::string &fileName, const std::shared_ptr<MappedFile> &file);
+	bool Fail(const std::string &location, const std::string &message);
+	int InternEntityType(const std::string &name);
+	void BuildTileFlags();
+	// the flags of tile ids 0 to count - 1 from the tile lists in helper.cpp
+	void AssignTileFlags(size_t count);
+	void BuildChunkSummary(int chunkX, int chunkY);
+	static unsigned int NextRevision();
 	
 };
 
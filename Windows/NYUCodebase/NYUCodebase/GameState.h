@@ -16,32 +16,42 @@
 #else
 #define RESOURCE_FOLDER "NYUCodebase.app/Contents/Resources/"
 #endif
-#define STB_IMAGE_IMPLEMENTATION
 
 #include "SpriteSheet.h"
 #include "Entity.h"
 #include "helper.h"
+#include "glhelper.h"
 #include "ShaderProgram.h"
 #include "FlareMap.h"
-#include "Hitbox.h"
+#include "Simulation.h"
+#include "TileMesh.h"
+#include "SpriteBatch.h"
+#include "TileMapRenderer.h"
+#include "TextCache.h"
+#include "TextureAtlas.h"
 #include <vector>
 
 struct GameState {
+	// every sheet below is packed in here, so a frame binds one texture
+	TextureAtlas atlas;
 	SpriteSheet Texture;
 	SpriteSheet PlayerSprites;
-	GLuint font;
+	SpriteSheet font;
+	// every animation's frames in the sheet it's drawn from
+	SpriteClip clips[CLIP_COUNT];
 
-	GameMode mode = STATE_MAIN_MENU;
+	Simulation sim;
+	SimInput input;
 
-	FlareMap level1 = FlareMap(TILE_SIZE);
-	FlareMap level2 = FlareMap(TILE_SIZE);
-	FlareMap level3 = FlareMap(TILE_SIZE);
+	// tiles are drawn by tileMap where the GL can run its shader, else from the mesh
+	TileMapRenderer tileMap;
+	bool useTileMap = false;
+	TileMesh tiles;
+	SpriteBatch sprites;
+	TextCache texts;
 
-	Entity player;
-	std::vector<Entity> annoying;
-	Entity victory;
 	ShaderProgram program;
-	Hitbox* hitbox = NULL;
+	glm::mat4 viewMatrix;
 	Mix_Music *background;
 	Mix_Chunk *door;
 
@@ -55,9 +65,16 @@ struct GameState {
 
 	void playSound();
 
-	void Render();
+	void Render(float alpha);
 
-	void RenderLevel(FlareMap& map);
+	// points the view at the player and returns what it can see
+	WorldRect SetCamera(const FlareMap& map, float alpha);
+
+	bool OnScreen(const Entity& entity, const WorldRect& view) const;
+
+	bool OnScreen(float x, float y, float width, float height, const WorldRect& view) const;
+
+	void RenderLevel(FlareMap& map, const WorldRect& view);
 
 	void RenderMenu();
 
@@ -65,23 +82,24 @@ struct GameState {
 
 	void RenderWin();
 
-	void Update(float elapsed);
+	void Update();
 
 	void ProcessInput(const Uint8 * keys);
 
 	void ProcessEvent(SDL_Event event);
 
-	void DrawTiles(FlareMap& map);
-
-	void DrawText(std::string text, float size, float spacing, float posx, float posy);
+	void DrawTiles(FlareMap& map, const WorldRect& view);
 
-	Entity placeEnemy(float x, float y);
+	// text that changes while it's shown, like a timer, passes a slot of its
+	// own (see TextCache); -1 keys the text by the string
+	void DrawText(std::string text, float size, float spacing, float posx, float posy, int slot = -1);
 
-	void SetEntities();
+	// queues the entity in sprites, drawn when the batch is flushed
+	void DrawEntity(const Entity& entity, float alpha);
 
-	void Load();
+	bool Load();
 
 };
 
 
-#endif 
\ No newline at end of file
+#endif 
@@ -1,6 +1,5 @@
 #include "helper.h"
 #include "Hitbox.h"
-#include <algorithm>
 
 
 bool Hitbox::checkFulfill(FlareMap* map) {
@@ -9,31 +8,31 @@ bool Hitbox::checkFulfill(FlareMap* map) {
 
     //top
     worldToTileCoordinates(body.x, body.y + 0.5f * body.height, &gridX, &gridY);
-    if (gridX >= 0 && gridX < map->mapWidth && gridY >= 0 && gridY < map->mapHeight) {
-        if (std::find(dangerTiles.begin(), dangerTiles.end(), map->mapData[gridY][gridX]) != dangerTiles.end()) {
+    if (map->mapData.InBounds(gridX, gridY)) {
+        if (map->TileFlags(gridX, gridY) & TILE_DANGER) {
             return true;
         }
     }
     //bottom
     worldToTileCoordinates(body.x, body.y - 0.5f * body.height, &gridX, &gridY);
-    if (gridX >= 0 && gridX < map->mapWidth && gridY >= 0 && gridY < map->mapHeight) {
-        if (std::find(dangerTiles.begin(), dangerTiles.end(), map->mapData[gridY][gridX]) != dangerTiles.end()) {
+    if (map->mapData.InBounds(gridX, gridY)) {
+        if (map->TileFlags(gridX, gridY) & TILE_DANGER) {
             return true;
         }
     }
 
     //left
     worldToTileCoordinates(body.x - 0.5f * body.width, body.y, &gridX, &gridY);
-    if (gridX >= 0 && gridX < map->mapWidth && gridY >= 0 && gridY < map->mapHeight) {
-        if (std::find(dangerTiles.begin(), dangerTiles.end(), map->mapData[gridY][gridX]) != dangerTiles.end()) {
+    if (map->mapData.InBounds(gridX, gridY)) {
+        if (map->TileFlags(gridX, gridY) & TILE_DANGER) {
             return true;
         }
     }
 
     //right
     worldToTileCoordinates(body.x + 0.5f * body.width, body.y, &gridX, &gridY);
-    if (gridX >= 0 && gridX < map->mapWidth && gridY >= 0 && gridY < map->mapHeight) {
-        if (std::find(dangerTiles.begin(), dangerTiles.end(), map->mapData[gridY][gridX]) != dangerTiles.end()) {
+    if (map->mapData.InBounds(gridX, gridY)) {
+        if (map->TileFlags(gridX, gridY) & TILE_DANGER) {
             return true;
         }
     }
@@ -0,0 +1,54 @@
+#ifndef LEVELFORMAT_H
+#define LEVELFORMAT_H
+
+#include <cstdint>
+
+// Compiled levels (.oofl), written by FlareMap::SaveBinary and the flare2oofl
+// tool and read in place by FlareMap::Load. Everything is little endian and
+// every section starts on a 16 byte boundary, so the tile cells can be used
+// straight out of the mapped file.
+//
+//   header
+//   tile cells     tileCount TileIDs in TileGrid storage order (chunk by chunk)
+//   tile flags     flagCount bytes, TileFlag bits per tile id when compiled;
+//                  loading rebuilds them from the current tile lists
+//   summaries      summaryCount BinaryChunkSummary, one per chunk
+//   entity types   typeBytes of null terminated type names
+//   entities       entityCount BinaryLevelEntity
+
+#define BINARY_LEVEL_MAGIC "OOFL"
+#define BINARY_LEVEL_VERSION 1
+
+struct BinaryLevelHeader {
+	char magic[4];
+	uint32_t version;
+	int32_t mapWidth;
+	int32_t mapHeight;
+	uint32_t chunkShift;
+	uint32_t tileIdBytes;
+
+	uint32_t tileOffset;
+	uint32_t tileCount;
+	uint32_t flagOffset;
+	uint32_t flagCount;
+	uint32_t summaryOffset;
+	uint32_t summaryCount;
+	uint32_t typeOffset;
+	uint32_t typeBytes;
+	uint32_t entityOffset;
+	uint32_t entityCount;
+};
+
+struct BinaryChunkSummary {
+	uint16_t tileCount;
+	uint8_t flags;
+	uint8_t padding;
+};
+
+struct BinaryLevelEntity {
+	uint32_t type;
+	float x;
+	float y;
+};
+
+#endif
@@ -0,0 +1,95 @@
+#include "LevelManager.h"
+#include "helper.h"
+#include <chrono>
+#include <filesystem>
+
+LevelManager::~LevelManager() {
+    // futures from std::async wait for their worker when destroyed
+    for (int i = 1; i <= LEVEL_COUNT; i++) {
+        if (pending[i].valid()) {
+            pending[i].wait();
+        }
+    }
+}
+
+void LevelManager::SetFolder(const std::string& resourceFolder) {
+    folder = resourceFolder;
+}
+
+std::string LevelManager::FileName(int level) const {
+    // a level compiled with flare2oofl is used over the Flare text file,
+    // unless the text was edited after it was compiled
+    std::string name = folder + "level" + std::to_string(level);
+    std::error_code error;
+    std::filesystem::file_time_type compiled = std::filesystem::last_write_time(name + ".oofl", error);
+    if (error) {
+        return name + ".txt";
+    }
+    std::filesystem::file_time_type source = std::filesystem::last_write_time(name + ".txt", error);
+    if (!error && source > compiled) {
+        return name + ".txt";
+    }
+    return name + ".oofl";
+}
+
+void LevelManager::Prefetch(int level) {
+    ReapRetired();
+    if (level < 1 || level > LEVEL_COUNT || resident[level] || pending[level].valid()) {
+        return;
+    }
+    std::string file = FileName(level);
+    std::string text = folder + "level" + std::to_string(level) + ".txt";
+    pending[level] = std::async(std::launch::async, [file, text]() {
+        std::shared_ptr<FlareMap> map = std::make_shared<FlareMap>(TILE_SIZE);
+        // a compiled level from an older build is no use, the text still is
+        if (!map->Load(file) && file != text) {
+            map->Load(text);
+        }
+        return map;
+    });
+}
+
+std::shared_ptr<FlareMap> LevelManager::Acquire(int level) {
+    if (level < 1 || level > LEVEL_COUNT) {
+        loadError = "there is no level " + std::to_string(level);
+        return nullptr;
+    }
+    if (!resident[level]) {
+        Prefetch(level);
+        std::shared_ptr<FlareMap> map = pending[level].get();
+        if (!map->loadError.empty()) {
+            loadError = map->loadError;
+            return nullptr;
+        }
+        resident[level] = map;
+    }
+    return resident[level];
+}
+
+void LevelManager::Retain(int current, int next) {
+    for (int i = 1; i <= LEVEL_COUNT; i++) {
+        if (i == current || i == next) {
+            continue;
+        }
+        resident[i].reset();
+        if (pending[i].valid()) {
+            retired.push_back(std::move(pending[i]));
+        }
+    }
+    ReapRetired();
+}
+
+bool LevelManager::IsResident(int level) const {
+    return level >= 1 && level <= LEVEL_COUNT && resident[level] != nullptr;
+}
+
+void LevelManager::ReapRetired() {
+    for (size_t i = 0; i < retired.size();) {
+        if (retired[i].wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+            retired.erase(retired.begin() + i);
+        }
+        else {
+            i++;
+        }
+    }
+}
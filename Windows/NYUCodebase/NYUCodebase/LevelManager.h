@@ -0,0 +1,47 @@
+#ifndef LEVELMANAGER_H
+#define LEVELMANAGER_H
+
+#include "FlareMap.h"
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#define LEVEL_COUNT 3
+
+// Owns the campaign's levels (numbered 1 to LEVEL_COUNT). Levels are loaded on
+// worker threads ahead of when they are needed and dropped once the game can
+// no longer reach them, so only the level being played and the next one are
+// ever resident.
+class LevelManager {
+public:
+	~LevelManager();
+
+	void SetFolder(const std::string& resourceFolder);
+
+	// starts loading a level in the background unless it is resident or loading
+	void Prefetch(int level);
+
+	// the level, waiting for its load if it hasn't finished yet; null if it
+	// failed to load, see loadError
+	std::shared_ptr<FlareMap> Acquire(int level);
+
+	// drops every level other than the two given ones
+	void Retain(int current, int next);
+
+	bool IsResident(int level) const;
+
+	std::string loadError;
+
+private:
+	std::string FileName(int level) const;
+	void ReapRetired();
+
+	std::string folder;
+	std::shared_ptr<FlareMap> resident[LEVEL_COUNT + 1];
+	std::future<std::shared_ptr<FlareMap>> pending[LEVEL_COUNT + 1];
+	// loads that were dropped while still running; waiting on them would stall
+	std::vector<std::future<std::shared_ptr<FlareMap>>> retired;
+};
+
+#endif
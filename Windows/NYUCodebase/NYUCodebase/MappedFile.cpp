@@ -0,0 +1,117 @@
+#include "MappedFile.h"
+
+#ifdef _WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WINDOWS
+
+MappedFile::MappedFile() {
+    fileHandle = INVALID_HANDLE_VALUE;
+    mappingHandle = NULL;
+    data = nullptr;
+    size = 0;
+}
+
+bool MappedFile::Open(const std::string& fileName) {
+    Close();
+    fileHandle = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize)) {
+        Close();
+        return false;
+    }
+    size = (size_t)fileSize.QuadPart;
+    if (size == 0) {
+        return true;
+    }
+    mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    if (mappingHandle == NULL) {
+        Close();
+        return false;
+    }
+    data = (char*)MapViewOfFile(mappingHandle, FILE_MAP_COPY, 0, 0, 0);
+    if (data == nullptr) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::Close() {
+    if (data) {
+        UnmapViewOfFile(data);
+    }
+    if (mappingHandle) {
+        CloseHandle(mappingHandle);
+    }
+    if (fileHandle != INVALID_HANDLE_VALUE) {
+        CloseHandle(fileHandle);
+    }
+    fileHandle = INVALID_HANDLE_VALUE;
+    mappingHandle = NULL;
+    data = nullptr;
+    size = 0;
+}
+
+#else
+
+MappedFile::MappedFile() {
+    fileDescriptor = -1;
+    data = nullptr;
+    size = 0;
+}
+
+bool MappedFile::Open(const std::string& fileName) {
+    Close();
+    fileDescriptor = open(fileName.c_str(), O_RDONLY);
+    if (fileDescriptor < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fileDescriptor, &info) != 0) {
+        Close();
+        return false;
+    }
+    size = (size_t)info.st_size;
+    if (size == 0) {
+        return true;
+    }
+    void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileDescriptor, 0);
+    if (mapping == MAP_FAILED) {
+        Close();
+        return false;
+    }
+    data = (char*)mapping;
+    // the loaders read front to back once
+    madvise(mapping, size, MADV_SEQUENTIAL);
+    return true;
+}
+
+void MappedFile::Close() {
+    if (data) {
+        munmap(data, size);
+    }
+    if (fileDescriptor >= 0) {
+        close(fileDescriptor);
+    }
+    fileDescriptor = -1;
+    data = nullptr;
+    size = 0;
+}
+
+#endif
+
+MappedFile::~MappedFile() {
+    Close();
+}
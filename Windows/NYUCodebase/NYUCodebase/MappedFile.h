@@ -0,0 +1,37 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+// A whole file mapped into memory, unmapped when the object goes away. Lets
+// the level loaders read file contents in place instead of copying them
+// through streams. The mapping is copy-on-write: the contents can be changed
+// through Data(), but the changes stay private and never reach the file.
+class MappedFile {
+public:
+	MappedFile();
+	~MappedFile();
+
+	bool Open(const std::string& fileName);
+	void Close();
+
+	char* Data() { return data; }
+	const char* Data() const { return data; }
+	size_t Size() const { return size; }
+
+private:
+	MappedFile(const MappedFile&);
+	MappedFile& operator=(const MappedFile&);
+
+#ifdef _WINDOWS
+	void* fileHandle;
+	void* mappingHandle;
+#else
+	int fileDescriptor;
+#endif
+	char* data;
+	size_t size;
+};
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef OBJECTPOOL_H
+#define OBJECTPOOL_H
+
+#include <cassert>
+
+// A fixed number of T stored inline. Acquire hands out a free slot and
+// Release gives it back, neither touches the heap. Everything handed out and
+// given back is counted, so an object that is never released shows up.
+template <typename T, int CAPACITY>
+class ObjectPool {
+public:
+	ObjectPool() {
+		for (int i = 0; i < CAPACITY; i++) {
+			// the lowest slots are handed out first
+			freeSlots[i] = CAPACITY - 1 - i;
+			live[i] = false;
+		}
+	}
+
+	ObjectPool(const ObjectPool&) = delete;
+	ObjectPool& operator=(const ObjectPool&) = delete;
+
+	// a default constructed T, or NULL if every slot is in use
+	T* Acquire() {
+		if (freeCount == 0) {
+			failed++;
+			return NULL;
+		}
+		int slot = freeSlots[--freeCount];
+		live[slot] = true;
+		items[slot] = T();
+		acquired++;
+		if (Live() > peak) {
+			peak = Live();
+		}
+		return &items[slot];
+	}
+
+	void Release(T* item) {
+		int slot = (int)(item - items);
+		assert(slot >= 0 && slot < CAPACITY && live[slot]);
+		live[slot] = false;
+		freeSlots[freeCount++] = slot;
+		released++;
+	}
+
+	void ReleaseAll() {
+		for (int i = 0; i < CAPACITY; i++) {
+			if (live[i]) {
+				Release(&items[i]);
+			}
+		}
+	}
+
+	// calls f on every object in use, in slot order. f may release the
+	// object it is given
+	template <typename F>
+	void ForEach(F f) {
+		for (int i = 0; i < CAPACITY; i++) {
+			if (live[i]) {
+				f(items[i]);
+			}
+		}
+	}
+
+	template <typename F>
+	void ForEach(F f) const {
+		for (int i = 0; i < CAPACITY; i++) {
+			if (live[i]) {
+				f(items[i]);
+			}
+		}
+	}
+
+	// the first object in use that f returns true for, or NULL
+	template <typename F>
+	T* Find(F f) {
+		for (int i = 0; i < CAPACITY; i++) {
+			if (live[i] && f(items[i])) {
+				return &items[i];
+			}
+		}
+		return NULL;
+	}
+
+	// the object in slot, or NULL if that slot is free
+	T* Get(int slot) { return live[slot] ? &items[slot] : NULL; }
+
+	int Slot(const T* item) const { return (int)(item - items); }
+
+	int Live() const { return CAPACITY - freeCount; }
+	int Capacity() const { return CAPACITY; }
+
+	// over the pool's whole life. Acquired() - Released() is always Live(),
+	// anything left live once its owner is done with it has leaked
+	long long Acquired() const { return acquired; }
+	long long Released() const { return released; }
+	// Acquires refused because the pool was full
+	long long Failed() const { return failed; }
+	int Peak() const { return peak; }
+
+private:
+	T items[CAPACITY];
+	bool live[CAPACITY];
+	int freeSlots[CAPACITY];
+	int freeCount = CAPACITY;
+	long long acquired = 0;
+	long long released = 0;
+	long long failed = 0;
+	int peak = 0;
+};
+
+#endif
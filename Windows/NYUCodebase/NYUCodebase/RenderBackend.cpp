@@ -0,0 +1,184 @@
+#include "RenderBackend.h"
+#include "RenderState.h"
+#include <algorithm>
+#include <vector>
+
+const VertexFormat TILE_VERTEX = {
+    sizeof(TileVertex),
+    { 2, GL_SHORT, GL_FALSE, offsetof(TileVertex, x) },
+    { 2, GL_UNSIGNED_SHORT, GL_TRUE, offsetof(TileVertex, u) }
+};
+
+const VertexFormat QUAD_VERTEX = {
+    sizeof(QuadVertex),
+    { 2, GL_FLOAT, GL_FALSE, offsetof(QuadVertex, x) },
+    { 2, GL_UNSIGNED_SHORT, GL_TRUE, offsetof(QuadVertex, u) }
+};
+
+const VertexFormat FLOAT_VERTEX = {
+    sizeof(FloatVertex),
+    { 2, GL_FLOAT, GL_FALSE, offsetof(FloatVertex, x) },
+    { 2, GL_FLOAT, GL_FALSE, offsetof(FloatVertex, u) }
+};
+
+// one index buffer for every quad mesh; growing it keeps the buffer name, so
+// vertex arrays that already use it stay valid
+static GLuint quadIndexBuffer = 0;
+static int quadIndexCapacity = 0;
+
+VertexArray::VertexArray(const VertexFormat& format_) : format(format_) {}
+
+VertexArray::~VertexArray() {
+    Destroy();
+}
+
+void VertexArray::CreateBuffers() {
+    if (vertexArray == 0) {
+        glGenVertexArrays(1, &vertexArray);
+        glGenBuffers(1, &vertexBuffer);
+        boundPosition = boundTexCoord = (GLuint)-1;
+    }
+}
+
+void VertexArray::Destroy() {
+    if (vertexArray != 0) {
+        renderState.ForgetVertexArray(vertexArray);
+        glDeleteVertexArrays(1, &vertexArray);
+        glDeleteBuffers(1, &vertexBuffer);
+        vertexArray = vertexBuffer = 0;
+    }
+    if (indexBuffer != 0 && !sharedIndices) {
+        glDeleteBuffers(1, &indexBuffer);
+    }
+    indexBuffer = 0;
+    sharedIndices = false;
+    vertexBytes = streamCapacity = 0;
+}
+
+void VertexArray::SetVertices(const void* data, size_t bytes, GLenum usage) {
+    CreateBuffers();
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, bytes, data, usage);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    vertexBytes = bytes;
+    streamCapacity = 0;
+}
+
+void VertexArray::UpdateVertices(size_t offset, const void* data, size_t bytes) {
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBufferSubData(GL_ARRAY_BUFFER, offset, bytes, data);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void VertexArray::StreamVertices(const void* data, size_t bytes) {
+    CreateBuffers();
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    if (bytes > streamCapacity) {
+        // grow with headroom so a batch that changes size a little doesn't reallocate
+        streamCapacity = bytes + bytes / 2;
+    }
+    // handing the driver a fresh store lets it keep the old one for draws in flight
+    glBufferData(GL_ARRAY_BUFFER, streamCapacity, NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, data);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    vertexBytes = bytes;
+}
+
+void VertexArray::SetIndices(const void* data, size_t bytes, GLenum indexType_) {
+    CreateBuffers();
+    if (sharedIndices) {
+        indexBuffer = 0;
+        sharedIndices = false;
+    }
+    if (indexBuffer == 0) {
+        glGenBuffers(1, &indexBuffer);
+    }
+    indexType = indexType_;
+    // the element buffer binding is part of the vertex array's state
+    renderState.BindVertexArray(vertexArray);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, bytes, data, GL_STATIC_DRAW);
+    renderState.BindVertexArray(0);
+}
+
+void VertexArray::UseQuadIndices(int quads) {
+    CreateBuffers();
+    if (quads > quadIndexCapacity) {
+        // round up so a slowly growing batch doesn't rebuild this every frame
+        int capacity = std::max(quads + quads / 2, 1024);
+        std::vector<GLuint> indices(capacity * 6);
+        for (int i = 0; i < capacity; i++) {
+            GLuint corner = i * 4;
+            GLuint* quad = &indices[i * 6];
+            quad[0] = corner;
+            quad[1] = corner + 1;
+            quad[2] = corner + 2;
+            quad[3] = corner;
+            quad[4] = corner + 2;
+            quad[5] = corner + 3;
+        }
+        if (quadIndexBuffer == 0) {
+            glGenBuffers(1, &quadIndexBuffer);
+        }
+        renderState.BindVertexArray(0);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quadIndexBuffer);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        quadIndexCapacity = capacity;
+    }
+    if (indexBuffer == quadIndexBuffer && sharedIndices) {
+        return;
+    }
+    if (indexBuffer != 0 && !sharedIndices) {
+        glDeleteBuffers(1, &indexBuffer);
+    }
+    indexBuffer = quadIndexBuffer;
+    sharedIndices = true;
+    indexType = GL_UNSIGNED_INT;
+    renderState.BindVertexArray(vertexArray);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+    renderState.BindVertexArray(0);
+}
+
+void VertexArray::Bind(const ShaderProgram& program) {
+    CreateBuffers();
+    renderState.BindVertexArray(vertexArray);
+    if (boundPosition == program.positionAttribute && boundTexCoord == program.texCoordAttribute) {
+        return;
+    }
+    if (boundPosition != (GLuint)-1) {
+        glDisableVertexAttribArray(boundPosition);
+        glDisableVertexAttribArray(boundTexCoord);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glVertexAttribPointer(program.positionAttribute, format.position.size, format.position.type,
+        format.position.normalized, format.stride, (const void*)format.position.offset);
+    glEnableVertexAttribArray(program.positionAttribute);
+    glVertexAttribPointer(program.texCoordAttribute, format.texCoord.size, format.texCoord.type,
+        format.texCoord.normalized, format.stride, (const void*)format.texCoord.offset);
+    glEnableVertexAttribArray(program.texCoordAttribute);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    boundPosition = program.positionAttribute;
+    boundTexCoord = program.texCoordAttribute;
+}
+
+void VertexArray::Unbind() const {
+    renderState.BindVertexArray(0);
+}
+
+void VertexArray::Draw(GLenum mode, GLint first, GLsizei count) const {
+    glDrawArrays(mode, first, count);
+}
+
+void VertexArray::DrawIndexed(GLenum mode, GLsizei count, size_t firstIndex) const {
+    size_t indexSize = indexType == GL_UNSIGNED_INT ? sizeof(GLuint) : sizeof(GLushort);
+    glDrawElements(mode, count, indexType, (const void*)(firstIndex * indexSize));
+}
+
+void VertexArray::MultiDrawIndexed(GLenum mode, const GLsizei* counts, const void* const* offsets, GLsizei runs) const {
+    glMultiDrawElements(mode, counts, indexType, offsets, runs);
+}
+
+void VertexArray::DrawQuads(int firstQuad, int quads) const {
+    glDrawElements(GL_TRIANGLES, quads * 6, GL_UNSIGNED_INT, (const void*)((size_t)firstQuad * 6 * sizeof(GLuint)));
+}
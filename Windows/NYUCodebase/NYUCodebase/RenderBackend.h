@@ -0,0 +1,114 @@
+#ifndef RENDERBACKEND_H
+#define RENDERBACKEND_H
+
+#include "glhelper.h"
+#include "ShaderProgram.h"
+#include <cstddef>
+
+// where one attribute sits inside a vertex
+struct VertexAttribute {
+	GLint size;
+	GLenum type;
+	GLboolean normalized;
+	size_t offset;
+};
+
+// the interleaved vertex layout of a VertexArray, fed to the shader's
+// position and texCoord attributes
+struct VertexFormat {
+	GLsizei stride;
+	VertexAttribute position;
+	VertexAttribute texCoord;
+};
+
+// texture coordinates stored as normalized 16 bit values
+inline GLushort PackUnit(float value) {
+	return (GLushort)(value * 65535.0f + 0.5f);
+}
+
+// a tile corner: position in whole tiles (drawn with a TILE_SIZE scale)
+struct TileVertex {
+	GLshort x, y;
+	GLushort u, v;
+};
+
+// a sprite or glyph corner
+struct QuadVertex {
+	float x, y;
+	GLushort u, v;
+};
+
+// everything as floats
+struct FloatVertex {
+	float x, y;
+	float u, v;
+};
+
+extern const VertexFormat TILE_VERTEX;
+extern const VertexFormat QUAD_VERTEX;
+extern const VertexFormat FLOAT_VERTEX;
+
+// A vertex array object with its own vertex buffer and an optional index
+// buffer. Static data is uploaded once with SetVertices, per-frame data goes
+// through StreamVertices, which orphans the old storage so the driver never
+// waits on a draw that is still reading it. Draws are bracketed by
+// Bind/Unbind so client side arrays keep working outside of it.
+class VertexArray {
+public:
+	VertexArray(const VertexFormat& format_);
+	~VertexArray();
+
+	VertexArray(const VertexArray&) = delete;
+	VertexArray& operator=(const VertexArray&) = delete;
+
+	// replaces the whole vertex buffer
+	void SetVertices(const void* data, size_t bytes, GLenum usage = GL_STATIC_DRAW);
+
+	// overwrites part of the vertex buffer in place
+	void UpdateVertices(size_t offset, const void* data, size_t bytes);
+
+	// replaces the vertex buffer with data that will only be drawn once
+	void StreamVertices(const void* data, size_t bytes);
+
+	// indexType is GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+	void SetIndices(const void* data, size_t bytes, GLenum indexType_);
+
+	// Uses the index buffer shared by everything drawn as quads, making sure
+	// it covers at least this many. Quad corners go top left, bottom left,
+	// bottom right, top right, four vertices each.
+	void UseQuadIndices(int quads);
+
+	// binds the vertex array, pointing it at the program's attributes the
+	// first time and whenever the program changes
+	void Bind(const ShaderProgram& program);
+	void Unbind() const;
+
+	void Draw(GLenum mode, GLint first, GLsizei count) const;
+	void DrawIndexed(GLenum mode, GLsizei count, size_t firstIndex = 0) const;
+	// several runs of indices in one call, offsets are in bytes
+	void MultiDrawIndexed(GLenum mode, const GLsizei* counts, const void* const* offsets, GLsizei runs) const;
+
+	// after UseQuadIndices
+	void DrawQuads(int firstQuad, int quads) const;
+
+	// frees the GL objects, they are created again on next use
+	void Destroy();
+
+	size_t VertexBytes() const { return vertexBytes; }
+
+private:
+	void CreateBuffers();
+
+	VertexFormat format;
+	GLuint vertexArray = 0;
+	GLuint vertexBuffer = 0;
+	GLuint indexBuffer = 0;
+	bool sharedIndices = false;
+	GLenum indexType = GL_UNSIGNED_SHORT;
+	size_t vertexBytes = 0;
+	size_t streamCapacity = 0;
+	GLuint boundPosition = (GLuint)-1;
+	GLuint boundTexCoord = (GLuint)-1;
+};
+
+#endif
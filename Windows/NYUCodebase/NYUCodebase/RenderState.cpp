@@ -0,0 +1,159 @@
+#include "RenderState.h"
+#include <cstring>
+#include <sstream>
+
+RenderState renderState;
+
+void RenderState::UseProgram(GLuint program_) {
+    if (programKnown && program == program_) {
+        programs.skipped++;
+        return;
+    }
+    glUseProgram(program_);
+    program = program_;
+    programKnown = true;
+    programs.issued++;
+}
+
+void RenderState::BindTexture(GLuint texture, int unit) {
+    if (unit >= TEXTURE_UNITS) {
+        // not tracked
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        activeUnit = unit;
+        textures.issued++;
+        return;
+    }
+    if (textureKnown[unit] && boundTextures[unit] == texture) {
+        textures.skipped++;
+        return;
+    }
+    if (activeUnit != unit) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        activeUnit = unit;
+    }
+    glBindTexture(GL_TEXTURE_2D, texture);
+    boundTextures[unit] = texture;
+    textureKnown[unit] = true;
+    textures.issued++;
+}
+
+void RenderState::BindVertexArray(GLuint vertexArray_) {
+    if (vertexArrayKnown && vertexArray == vertexArray_) {
+        vertexArrays.skipped++;
+        return;
+    }
+    glBindVertexArray(vertexArray_);
+    vertexArray = vertexArray_;
+    vertexArrayKnown = true;
+    vertexArrays.issued++;
+}
+
+bool RenderState::UniformIsSet(GLint location, const float* values, int count) {
+    size_t bytes = count * sizeof(float);
+    if (programKnown) {
+        for (UniformValue& uniform : uniformValues) {
+            if (uniform.program == program && uniform.location == location) {
+                if (memcmp(uniform.values, values, bytes) == 0) {
+                    uniforms.skipped++;
+                    return true;
+                }
+                memcpy(uniform.values, values, bytes);
+                uniforms.issued++;
+                return false;
+            }
+        }
+        UniformValue uniform;
+        uniform.program = program;
+        uniform.location = location;
+        memcpy(uniform.values, values, bytes);
+        uniformValues.push_back(uniform);
+    }
+    uniforms.issued++;
+    return false;
+}
+
+void RenderState::UniformMatrix(GLint location, const glm::mat4& matrix) {
+    if (location < 0 || UniformIsSet(location, &matrix[0][0], 16)) {
+        return;
+    }
+    glUniformMatrix4fv(location, 1, GL_FALSE, &matrix[0][0]);
+}
+
+void RenderState::Uniform4f(GLint location, float x, float y, float z, float w) {
+    float values[] = { x, y, z, w };
+    if (location < 0 || UniformIsSet(location, values, 4)) {
+        return;
+    }
+    glUniform4f(location, x, y, z, w);
+}
+
+void RenderState::Uniform2f(GLint location, float x, float y) {
+    float values[] = { x, y };
+    if (location < 0 || UniformIsSet(location, values, 2)) {
+        return;
+    }
+    glUniform2f(location, x, y);
+}
+
+void RenderState::Uniform1i(GLint location, int value) {
+    // compared bit for bit, so the int can share the float storage
+    float stored;
+    memcpy(&stored, &value, sizeof(stored));
+    if (location < 0 || UniformIsSet(location, &stored, 1)) {
+        return;
+    }
+    glUniform1i(location, value);
+}
+
+void RenderState::ForgetProgram(GLuint program_) {
+    for (size_t i = 0; i < uniformValues.size();) {
+        if (uniformValues[i].program == program_) {
+            uniformValues.erase(uniformValues.begin() + i);
+        }
+        else {
+            i++;
+        }
+    }
+    if (program == program_) {
+        programKnown = false;
+    }
+}
+
+void RenderState::ForgetTexture(GLuint texture) {
+    for (int i = 0; i < TEXTURE_UNITS; i++) {
+        if (boundTextures[i] == texture) {
+            textureKnown[i] = false;
+        }
+    }
+}
+
+void RenderState::ForgetVertexArray(GLuint vertexArray_) {
+    if (vertexArray == vertexArray_) {
+        vertexArrayKnown = false;
+    }
+}
+
+void RenderState::Invalidate() {
+    programKnown = false;
+    activeUnit = -1;
+    for (int i = 0; i < TEXTURE_UNITS; i++) {
+        textureKnown[i] = false;
+    }
+    vertexArrayKnown = false;
+    uniformValues.clear();
+}
+
+void RenderState::ResetCounters() {
+    programs = textures = vertexArrays = uniforms = RenderCounter();
+}
+
+std::string RenderState::Report() const {
+    std::ostringstream out;
+    out << "programs " << programs.issued << "/" << programs.skipped
+        << ", textures " << textures.issued << "/" << textures.skipped
+        << ", vertex arrays " << vertexArrays.issued << "/" << vertexArrays.skipped
+        << ", uniforms " << uniforms.issued << "/" << uniforms.skipped
+        << " (issued/skipped)";
+    return out.str();
+}
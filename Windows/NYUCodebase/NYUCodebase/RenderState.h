@@ -0,0 +1,74 @@
+#ifndef RENDERSTATE_H
+#define RENDERSTATE_H
+
+#include "glhelper.h"
+#include "glm/mat4x4.hpp"
+#include <string>
+#include <vector>
+
+// calls passed on to GL against calls dropped because they changed nothing
+struct RenderCounter {
+	int issued = 0;
+	int skipped = 0;
+};
+
+// Remembers the bound program, textures and vertex array and the last value
+// of every uniform set through it, and drops calls that would set them to
+// what they already are. Everything that draws goes through renderState;
+// code that touches this state behind its back has to call Invalidate.
+class RenderState {
+public:
+	void UseProgram(GLuint program);
+	void BindTexture(GLuint texture, int unit = 0);
+	void BindVertexArray(GLuint vertexArray);
+
+	// set a uniform of the program in use
+	void UniformMatrix(GLint location, const glm::mat4& matrix);
+	void Uniform4f(GLint location, float x, float y, float z, float w);
+	void Uniform2f(GLint location, float x, float y);
+	void Uniform1i(GLint location, int value);
+
+	// for objects about to be deleted, their names can be reused
+	void ForgetProgram(GLuint program);
+	void ForgetTexture(GLuint texture);
+	void ForgetVertexArray(GLuint vertexArray);
+
+	// forgets everything, the next call of each kind is issued
+	void Invalidate();
+
+	RenderCounter programs;
+	RenderCounter textures;
+	RenderCounter vertexArrays;
+	RenderCounter uniforms;
+
+	void ResetCounters();
+
+	// "issued/skipped" for each kind of call
+	std::string Report() const;
+
+private:
+	static const int TEXTURE_UNITS = 4;
+
+	struct UniformValue {
+		GLuint program;
+		GLint location;
+		float values[16];
+	};
+
+	// true if the uniform already holds these values, else records them
+	bool UniformIsSet(GLint location, const float* values, int count);
+
+	// 0 is a real binding, so "unknown" is kept apart from it
+	bool programKnown = false;
+	GLuint program = 0;
+	int activeUnit = -1;
+	bool textureKnown[TEXTURE_UNITS] = {};
+	GLuint boundTextures[TEXTURE_UNITS] = {};
+	bool vertexArrayKnown = false;
+	GLuint vertexArray = 0;
+	std::vector<UniformValue> uniformValues;
+};
+
+extern RenderState renderState;
+
+#endif
@@ -1,5 +1,6 @@
 
 #include "ShaderProgram.h"
+#include "RenderState.h"
 
 void ShaderProgram::Load(const char *vertexShaderFile, const char *fragmentShaderFile) {
     
@@ -33,6 +34,7 @@ void ShaderProgram::Load(const char *vertexShaderFile, const char *fragmentShade
 }
 
 void ShaderProgram::Cleanup() {
+    renderState.ForgetProgram(programID);
     glDeleteProgram(programID);
     glDeleteShader(vertexShader);
     glDeleteShader(fragmentShader);
@@ -84,21 +86,21 @@ GLuint ShaderProgram::LoadShaderFromString(const std::string &shaderContents, GL
 }
 
 void ShaderProgram::SetColor(float r, float g, float b, float a) {
-	glUseProgram(programID);
-	glUniform4f(colorUniform, r, g, b, a);
+	renderState.UseProgram(programID);
+	renderState.Uniform4f(colorUniform, r, g, b, a);
 }
 
 void ShaderProgram::SetViewMatrix(const glm::mat4 &matrix) {
-    glUseProgram(programID);
-    glUniformMatrix4fv(viewMatrixUniform, 1, GL_FALSE, &matrix[0][0]);
+    renderState.UseProgram(programID);
+    renderState.UniformMatrix(viewMatrixUniform, matrix);
 }
 
 void ShaderProgram::SetModelMatrix(const glm::mat4 &matrix) {
-    glUseProgram(programID);
-    glUniformMatrix4fv(modelMatrixUniform, 1, GL_FALSE, &matrix[0][0]);
+    renderState.UseProgram(programID);
+    renderState.UniformMatrix(modelMatrixUniform, matrix);
 }
 
 void ShaderProgram::SetProjectionMatrix(const glm::mat4 &matrix) {
-    glUseProgram(programID);
-    glUniformMatrix4fv(projectionMatrixUniform, 1, GL_FALSE, &matrix[0][0]);    
+    renderState.UseProgram(programID);
+    renderState.UniformMatrix(projectionMatrixUniform, matrix);    
 }
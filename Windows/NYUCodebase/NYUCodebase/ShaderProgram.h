@@ -1,10 +1,6 @@
 #pragma once
 
-#ifdef _WINDOWS
-	#include <GL/glew.h>
-#endif
-#define GL_GLEXT_PROTOTYPES 1
-#include <SDL_opengl.h>
+#include "glhelper.h"
 #include <string>
 #include <iostream>
 #include <fstream>
@@ -0,0 +1,345 @@
+#include "Simulation.h"
+#include <algorithm>
+#include <iostream>
+#include <math.h>
+
+void SimInput::ClearPresses() {
+    start = skipLevel = wallJumpLeft = wallJumpRight = barrierUp = barrierDown = false;
+}
+
+bool Simulation::Load(const std::string& resourceFolder) {
+    levels.SetFolder(resourceFolder);
+    if (!levels.Acquire(1)) {
+        std::cout << levels.loadError << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int Simulation::Step(const SimInput& input) {
+    ProcessPresses(input);
+    ProcessInput(input);
+    Animate(FIXED_TIMESTEP);
+
+    // a level transition in the middle of the step may evict this level,
+    // hold on to it until the step is done
+    std::shared_ptr<FlareMap> map = CurrentLevel() ? level : nullptr;
+    if (map) {
+        return UpdateLevel(*map, FIXED_TIMESTEP);
+    }
+    return SIM_EVENT_NONE;
+}
+
+FlareMap* Simulation::CurrentLevel() {
+    switch (mode) {
+    case (STATE_GAME_LEVEL1):
+    case (STATE_GAME_LEVEL2):
+    case (STATE_GAME_LEVEL3):
+        return level.get();
+    default:
+        return NULL;
+    }
+}
+
+void Simulation::ProcessPresses(const SimInput& input) {
+    if (input.start) {
+        if (mode == STATE_MAIN_MENU) {
+            mode = STATE_GAME_LEVEL1;
+            SetEntities();
+        }
+        else if (mode == STATE_GAME_OVER) {
+            mode = STATE_MAIN_MENU;
+            SetEntities();
+        }
+        else if (mode == STATE_WIN) {
+            mode = STATE_MAIN_MENU;
+            SetEntities();
+        }
+    }
+
+    if (input.skipLevel) {
+        if (mode == STATE_GAME_LEVEL1) {
+            mode = STATE_GAME_LEVEL2;
+            SetEntities();
+        }
+        else if (mode == STATE_GAME_LEVEL2) {
+            mode = STATE_GAME_LEVEL3;
+            SetEntities();
+        }
+        else if (mode == STATE_GAME_LEVEL3) {
+            mode = STATE_MAIN_MENU;
+        }
+    }
+
+    if (input.wallJumpLeft) {
+        if (player.wallJump && player.collidedLeft) {
+            player.wallJump = player.collidedLeft = false;
+            player.wallJumpFrames = 0.0f;
+            player.velX = TILE_SIZE * 20;
+            player.accX = 0.5f;
+            player.velY = TILE_SIZE * 8;
+            player.spriteSet = 2; 
+        }
+    }
+    if (input.wallJumpRight) {
+        if (player.wallJump && player.collidedRight) {
+            player.wallJump = player.collidedRight = false;
+            player.wallJumpFrames = 0.0f; 
+            player.velX = -TILE_SIZE * 20;
+            player.accX = -0.5f; 
+            player.velY = TILE_SIZE * 8;
+            player.spriteSet = 1;
+        }
+    }
+    if (input.barrierUp) {
+        SpawnBarrier(true);
+    }
+    if (input.barrierDown) {
+        SpawnBarrier(false);
+    }
+}
+
+void Simulation::ProcessInput(const SimInput& input) {
+    switch (mode) {
+    case (STATE_MAIN_MENU):
+    case (STATE_GAME_OVER):
+    case (STATE_WIN):
+        break;
+    
+    case (STATE_GAME_LEVEL1):
+    case (STATE_GAME_LEVEL2):
+    case (STATE_GAME_LEVEL3):
+        if (input.left) {
+            player.accX = -1.05f;
+            player.spriteSet = 1; 
+        }
+        if (input.right) {
+            player.accX = 1.05f;
+            player.spriteSet = 2;
+        }
+        if (!(input.left || input.right)) {
+            if (player.collidedBottom) {
+                player.accX = 0.0f;
+                player.spriteSet = 0;
+            }
+        }
+        if (input.jump) {
+            if (player.collidedBottom) {
+                player.velY = 1.0f;
+            }
+        }
+        break;
+    }
+}
+
+void Simulation::Animate(float elapsed) {
+    animationElapsed += elapsed;
+    if (animationElapsed > 1.0 / framesPerSecond) {
+        player.NextFrame();
+        victory.NextFrame();
+        animationElapsed = 0.0f;
+
+        enemies.Animate();
+    }
+}
+
+int Simulation::UpdateLevel(FlareMap& map, float elapsed) {
+    int events = SIM_EVENT_NONE;
+    if (player.CollidesWith(victory)) {
+        events |= SIM_EVENT_LEVEL_CLEARED;
+        if (mode == STATE_GAME_LEVEL1) {
+            mode = STATE_GAME_LEVEL2;
+            SetEntities();
+        }
+        else if (mode == STATE_GAME_LEVEL2) {
+            mode = STATE_GAME_LEVEL3;
+            SetEntities();
+        }
+        else {
+            mode = STATE_WIN;
+        }
+    }
+    barriers.ForEach([&](Hitbox& barrier) {
+        barrier.timeAlive += elapsed;
+        if (barrier.timeAlive > 1.0f) {
+            barriers.Release(&barrier);
+            return;
+        }
+        barrier.body.prevX = barrier.body.x;
+        barrier.body.prevY = barrier.body.y;
+        barrier.body.x = player.x;
+        barrier.body.y = barrier.direction ?
+            player.y + (player.height*0.5f) + (TILE_SIZE * 0.5f) :
+            player.y - (player.height*0.5f) - (TILE_SIZE * 0.5f);
+
+        if (barrier.checkFulfill(&map)) {
+            player.velY = barrier.direction ? -1.0f : 1.0f;
+            barriers.Release(&barrier);
+        }
+    });
+    // moving the enemies doesn't depend on the player or the barriers
+    // touching them, so they all move first
+    enemies.Step(elapsed, player.x, map);
+    // contacts come in the order a loop over the enemies would meet them, so
+    // the lowest enemy takes a barrier two enemies touch
+    FindContacts();
+    int knocked = -1;
+    for (const OverlapPair& contact : contacts) {
+        int i = contact.first;
+        if (contact.second == 0) {
+            if (enemies.CollidesWith(i, player)) {
+                mode = STATE_GAME_OVER;
+            }
+            continue;
+        }
+        // an enemy only takes out one barrier
+        Hitbox* barrier = barriers.Get(contact.second - 1);
+        if (i == knocked || !barrier || !enemies.CollidesWith(i, barrier->body)) {
+            continue;
+        }
+        barriers.Release(barrier);
+        if (player.y > enemies.y[i]) {
+            player.velY = 1.0f; 
+        }
+        enemies.y[i] -= 1000.0f;
+        enemies.prevY[i] = enemies.y[i];
+        broadphase.Set(firstEnemyProxy + i, enemies.x[i], enemies.y[i], enemies.width[i], enemies.height[i]);
+        knocked = i;
+    }
+    if (player.Update(elapsed, &map)) {
+        mode = STATE_GAME_OVER;
+    }
+    return events;
+}
+
+void Simulation::SpawnBarrier(bool direction) {
+    if (barriers.Live() >= barrierLimit) {
+        return;
+    }
+    Hitbox* barrier = barriers.Acquire();
+    if (barrier == NULL) {
+        return;
+    }
+    float offset = (player.height*0.5f) + (TILE_SIZE * 0.5f);
+    barrier->timeAlive = 0.0f;
+    barrier->direction = direction;
+    barrier->body = Entity(player.x, direction ? player.y + offset : player.y - offset, TILE_SIZE, TILE_SIZE * 0.5f, true);
+    barrier->body.spriteIndex = 0;
+    barrier->body.SetClip(direction ? CLIP_BARRIER_UP : CLIP_BARRIER_DOWN);
+}
+
+void Simulation::FindContacts() {
+    broadphase.Set(playerProxy, player.x, player.y, player.width, player.height);
+    for (int slot = 0; slot < MAX_BARRIERS; slot++) {
+        const Hitbox* barrier = barriers.Get(slot);
+        if (barrier) {
+            broadphase.Set(barrierProxies[slot], barrier->body.x, barrier->body.y, barrier->body.width, barrier->body.height);
+        }
+        else {
+            broadphase.Disable(barrierProxies[slot]);
+        }
+    }
+    // sleeping enemies haven't moved since their boxes were last set
+    auto moved = [&](int i) {
+        broadphase.Set(firstEnemyProxy + i, enemies.x[i], enemies.y[i], enemies.width[i], enemies.height[i]);
+    };
+    enemies.ForEachAwake(moved);
+    for (int i : enemies.Slept()) {
+        moved(i);
+    }
+
+    contacts.clear();
+    broadphase.FindPairs(contacts);
+    for (OverlapPair& contact : contacts) {
+        int enemy = contact.first;
+        int other = contact.second;
+        if (broadphase.Layer(enemy) != LAYER_ENEMY) {
+            std::swap(enemy, other);
+        }
+        contact.first = broadphase.Id(enemy);
+        contact.second = broadphase.Layer(other) == LAYER_PLAYER ? 0 : 1 + broadphase.Id(other);
+    }
+    std::sort(contacts.begin(), contacts.end(), [](const OverlapPair& a, const OverlapPair& b) {
+        return a.first != b.first ? a.first < b.first : a.second < b.second;
+    });
+}
+
+int Simulation::placeEnemy(float x, float y) {
+    int index = enemies.Add(x, y, TILE_SIZE, TILE_SIZE);
+    int proxy = broadphase.Add(LAYER_ENEMY, index);
+    broadphase.Set(proxy, x, y, TILE_SIZE, TILE_SIZE);
+    return index;
+}
+
+void Simulation::SetEntities() {
+    barriers.ReleaseAll();
+    // keeps its storage, so restarting a level doesn't allocate
+    enemies.Clear();
+    broadphase.Clear();
+    broadphase.SetCollides(LAYER_ENEMY, LAYER_PLAYER, true);
+    broadphase.SetCollides(LAYER_ENEMY, LAYER_BARRIER, true);
+    playerProxy = broadphase.Add(LAYER_PLAYER, 0);
+    for (int slot = 0; slot < MAX_BARRIERS; slot++) {
+        barrierProxies[slot] = broadphase.Add(LAYER_BARRIER, slot);
+    }
+    firstEnemyProxy = broadphase.Count();
+    int index = 0;
+    switch (mode) {
+    case (STATE_GAME_LEVEL1):
+        index = 1;
+        break;
+    case (STATE_GAME_LEVEL2):
+        index = 2;
+        break;
+    case (STATE_GAME_LEVEL3):
+        index = 3;
+        break;
+    default:
+        break;
+    }
+    if (index == 0) {
+        // from the menus the only way back in is level 1
+        level = nullptr;
+        levels.Retain(1, 1);
+        levels.Prefetch(1);
+        //maybe move player entity off screen
+        return;
+    }
+
+    level = levels.Acquire(index);
+    if (!level) {
+        std::cout << levels.loadError << std::endl;
+        mode = STATE_MAIN_MENU;
+        SetEntities();
+        return;
+    }
+    // the current level can only lead to the next one
+    levels.Retain(index, index + 1);
+    levels.Prefetch(index + 1);
+    FlareMap* map = level.get();
+
+    player = Entity(
+        map->entities[0].x, map->entities[0].y,
+        TILE_SIZE, TILE_SIZE, false
+    );
+    player.spriteIndex = 0;
+    player.SetClips(CLIP_PLAYER_IDLE, CLIP_PLAYER_FORWARD, CLIP_PLAYER_BACKWARD);
+
+    victory = Entity(
+        map->entities[1].x, map->entities[1].y,
+        TILE_SIZE, TILE_SIZE, false
+    );
+    victory.spriteIndex = 0;
+    victory.SetClip(CLIP_VICTORY);
+
+    // level 2 is played without enemies
+    if (mode != STATE_GAME_LEVEL2) {
+        int annoyingType = map->EntityType("Annoying");
+        enemies.Reserve((int)map->entities.size());
+        for (const FlareMapEntity& i : map->entities) {
+            if (i.type == annoyingType) {
+                placeEnemy(i.x, i.y);
+            }
+        }
+    }
+}
@@ -0,0 +1,98 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include "Entity.h"
+#include "helper.h"
+#include "FlareMap.h"
+#include "Hitbox.h"
+#include "Enemies.h"
+#include "LevelManager.h"
+#include "ObjectPool.h"
+#include "SweepAndPrune.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+// Player input for one simulation step. The held keys are sampled every
+// step, the presses are one-shot and should be cleared once a step has run.
+struct SimInput {
+	bool left = false;
+	bool right = false;
+	bool jump = false;
+
+	bool start = false;
+	bool skipLevel = false;
+	bool wallJumpLeft = false;
+	bool wallJumpRight = false;
+	bool barrierUp = false;
+	bool barrierDown = false;
+
+	void ClearPresses();
+};
+
+// Events raised by a step, for the front end to react to (sound etc.)
+enum SimEvent { SIM_EVENT_NONE = 0, SIM_EVENT_LEVEL_CLEARED = 1 };
+
+// barriers that can exist at once, however many the rules allow
+static const int MAX_BARRIERS = 8;
+
+// broadphase layers, enemies only collide with the other two
+enum CollisionLayer { LAYER_PLAYER, LAYER_BARRIER, LAYER_ENEMY };
+
+// Everything that makes up a play session without any SDL or GL: the level
+// state machine, the entities and their tile collision. Step() advances the
+// game by exactly one FIXED_TIMESTEP, so it can run headless as fast as the
+// CPU allows.
+struct Simulation {
+	GameMode mode = STATE_MAIN_MENU;
+
+	// streams the levels in, only the one being played and the next are kept
+	LevelManager levels;
+	std::shared_ptr<FlareMap> level;
+
+	Entity player;
+	Enemies enemies;
+	Entity victory;
+	// barriers in play, SpawnBarrier won't add one while barrierLimit are up
+	ObjectPool<Hitbox, MAX_BARRIERS> barriers;
+	int barrierLimit = 1;
+
+	// one proxy for the player, one per barrier slot, then one per enemy
+	SweepAndPrune broadphase;
+	int playerProxy = 0;
+	int barrierProxies[MAX_BARRIERS] = {};
+	int firstEnemyProxy = 0;
+	// reused every step
+	std::vector<OverlapPair> contacts;
+
+	float animationElapsed = 0.0f;
+
+	// loads level 1, false if it fails to load (the reason is printed).
+	// Later levels are loaded in the background while the previous one is played
+	bool Load(const std::string& resourceFolder);
+
+	int Step(const SimInput& input);
+
+	FlareMap* CurrentLevel();
+
+	void ProcessPresses(const SimInput& input);
+
+	void ProcessInput(const SimInput& input);
+
+	void Animate(float elapsed);
+
+	int UpdateLevel(FlareMap& map, float elapsed);
+
+	// the enemies touching the player or a barrier, as (enemy, 0) for the
+	// player and (enemy, 1 + slot) for a barrier, sorted
+	void FindContacts();
+
+	void SpawnBarrier(bool direction);
+
+	// adds a sleeping enemy, returns its index in enemies
+	int placeEnemy(float x, float y);
+
+	void SetEntities();
+};
+
+#endif
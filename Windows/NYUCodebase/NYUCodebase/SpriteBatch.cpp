@@ -0,0 +1,64 @@
+#include "SpriteBatch.h"
+#include "RenderState.h"
+#include "glm/mat4x4.hpp"
+#include <algorithm>
+
+void SpriteBatch::Add(GLuint texture, const UVRect& uv, float x, float y, float width, float height) {
+    Sprite sprite;
+    sprite.texture = texture;
+    sprite.order = (int)sprites.size();
+    sprite.x = x;
+    sprite.y = y;
+    sprite.halfWidth = width * 0.5f;
+    sprite.halfHeight = height * 0.5f;
+    sprite.uv = uv;
+    sprites.push_back(sprite);
+}
+
+void SpriteBatch::Flush(ShaderProgram& program) {
+    drawCalls = 0;
+    if (sprites.empty()) {
+        return;
+    }
+    std::sort(sprites.begin(), sprites.end(), [](const Sprite& a, const Sprite& b) {
+        return a.texture != b.texture ? a.texture < b.texture : a.order < b.order;
+    });
+
+    vertices.clear();
+    for (const Sprite& s : sprites) {
+        float left = s.x - s.halfWidth;
+        float right = s.x + s.halfWidth;
+        float bottom = s.y - s.halfHeight;
+        float top = s.y + s.halfHeight;
+        GLushort u0 = PackUnit(s.uv.left);
+        GLushort u1 = PackUnit(s.uv.right);
+        GLushort v0 = PackUnit(s.uv.top);
+        GLushort v1 = PackUnit(s.uv.bottom);
+        vertices.push_back({ left, top, u0, v0 });
+        vertices.push_back({ left, bottom, u0, v1 });
+        vertices.push_back({ right, bottom, u1, v1 });
+        vertices.push_back({ right, top, u1, v0 });
+    }
+
+    renderState.UseProgram(program.programID);
+    program.SetModelMatrix(glm::mat4(1.0f));
+    mesh.StreamVertices(vertices.data(), vertices.size() * sizeof(QuadVertex));
+    mesh.UseQuadIndices((int)sprites.size());
+    mesh.Bind(program);
+
+    // one draw for each run of sprites sharing a texture
+    size_t start = 0;
+    while (start < sprites.size()) {
+        size_t end = start + 1;
+        while (end < sprites.size() && sprites[end].texture == sprites[start].texture) {
+            end++;
+        }
+        renderState.BindTexture(sprites[start].texture);
+        mesh.DrawQuads((int)start, (int)(end - start));
+        drawCalls++;
+        start = end;
+    }
+
+    mesh.Unbind();
+    sprites.clear();
+}
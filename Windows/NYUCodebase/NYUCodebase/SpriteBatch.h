@@ -0,0 +1,38 @@
+#ifndef SPRITEBATCH_H
+#define SPRITEBATCH_H
+
+#include "glhelper.h"
+#include "SpriteSheet.h"
+#include "ShaderProgram.h"
+#include "RenderBackend.h"
+#include <vector>
+
+// Collects the frame's sprites and draws them with one draw call per texture.
+// Vertices are placed in world space on the CPU, so there is no per-sprite
+// model matrix. Sprites sharing a texture keep the order they were added in.
+class SpriteBatch {
+public:
+	// queues a rectangle of a texture, centred on (x, y)
+	void Add(GLuint texture, const UVRect& uv, float x, float y, float width, float height);
+
+	// draws everything queued since the last flush and empties the batch
+	void Flush(ShaderProgram& program);
+
+	int DrawCalls() const { return drawCalls; }
+
+private:
+	struct Sprite {
+		GLuint texture;
+		int order;
+		float x, y;
+		float halfWidth, halfHeight;
+		UVRect uv;
+	};
+
+	std::vector<Sprite> sprites;
+	std::vector<QuadVertex> vertices;
+	VertexArray mesh{ QUAD_VERTEX };
+	int drawCalls = 0;
+};
+
+#endif
@@ -1,9 +1,36 @@
 #include "SpriteSheet.h"
 
-SpriteSheet::SpriteSheet() {}
+bool UVRect::operator==(const UVRect& other) const {
+    return left == other.left && top == other.top && right == other.right && bottom == other.bottom;
+}
+
+SpriteSheet::SpriteSheet() : textureID(0), spriteCountX(0), spriteCountY(0), region{ 0.0f, 0.0f, 1.0f, 1.0f } {}
+
+SpriteSheet::SpriteSheet(unsigned int textureID_, int x, int y) : SpriteSheet(textureID_, x, y, { 0.0f, 0.0f, 1.0f, 1.0f }) {}
 
-SpriteSheet::SpriteSheet(unsigned int textureID_, int x, int y) {
+SpriteSheet::SpriteSheet(unsigned int textureID_, int x, int y, const UVRect& region_) {
     textureID = textureID_;
     spriteCountX = x;
     spriteCountY = y;
+    region = region_;
+    float spriteWidth = (region.right - region.left) / (float)x;
+    float spriteHeight = (region.bottom - region.top) / (float)y;
+    std::vector<UVRect>* table = new std::vector<UVRect>(x * y);
+    for (int i = 0; i < x * y; i++) {
+        UVRect& frame = (*table)[i];
+        frame.left = region.left + (float)(i % x) * spriteWidth;
+        frame.top = region.top + (float)(i / x) * spriteHeight;
+        frame.right = frame.left + spriteWidth;
+        frame.bottom = frame.top + spriteHeight;
+    }
+    frames.reset(table);
+}
+
+SpriteClip SpriteSheet::Clip(const std::vector<int>& clipFrames) const {
+    SpriteClip clip;
+    clip.textureID = textureID;
+    for (int frame : clipFrames) {
+        clip.frames.push_back(HasFrame(frame) ? Frame(frame) : UVRect{ 0.0f, 0.0f, 0.0f, 0.0f });
+    }
+    return clip;
 }
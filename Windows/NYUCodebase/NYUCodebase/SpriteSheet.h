@@ -1,14 +1,45 @@
 #ifndef SPRITESHEET_H
 #define SPRITESHEET_H
 
+#include <memory>
+#include <vector>
+
+// texture coordinates of a rectangle, v runs down the image
+struct UVRect {
+	float left;
+	float top;
+	float right;
+	float bottom;
+
+	bool operator==(const UVRect& other) const;
+};
+
+// an animation's frames looked up in a sheet, ready to draw
+struct SpriteClip {
+	unsigned int textureID = 0;
+	std::vector<UVRect> frames;
+};
+
 struct SpriteSheet {
 	unsigned int textureID;
 	int spriteCountX;
 	int spriteCountY;
+	// where the sheet sits in its texture, all of it unless it was packed in an atlas
+	UVRect region;
+	// every frame's rectangle in the texture, row by row. Worked out once when
+	// the sheet is made and shared by its copies
+	std::shared_ptr<const std::vector<UVRect>> frames;
 
 	SpriteSheet();
 	SpriteSheet(unsigned int textureID_, int x, int y);
+	SpriteSheet(unsigned int textureID_, int x, int y, const UVRect& region_);
+
+	bool HasFrame(int index) const { return frames && index >= 0 && index < (int)frames->size(); }
+	const UVRect& Frame(int index) const { return (*frames)[index]; }
+
+	// frames the sheet doesn't have come out empty
+	SpriteClip Clip(const std::vector<int>& clipFrames) const;
 
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,112 @@
+#include "SweepAndPrune.h"
+#include "helper.h"
+#include <algorithm>
+
+// far more than the rounding between these boxes and CollidesWith's test
+const float SweepAndPrune::MARGIN = TILE_SIZE * 0.01f;
+
+void SweepAndPrune::Clear() {
+    minX.clear();
+    maxX.clear();
+    minY.clear();
+    maxY.clear();
+    layers.clear();
+    ids.clear();
+    enabled.clear();
+    order.clear();
+}
+
+int SweepAndPrune::Add(int layer, int id) {
+    int proxy = (int)ids.size();
+    minX.push_back(0.0f);
+    maxX.push_back(0.0f);
+    minY.push_back(0.0f);
+    maxY.push_back(0.0f);
+    layers.push_back(layer);
+    ids.push_back(id);
+    enabled.push_back(false);
+    order.push_back(proxy);
+    added = true;
+    return proxy;
+}
+
+void SweepAndPrune::SetCollides(int layerA, int layerB, bool collides_) {
+    if (collides_) {
+        collides[layerA] |= 1u << layerB;
+        collides[layerB] |= 1u << layerA;
+    }
+    else {
+        collides[layerA] &= ~(1u << layerB);
+        collides[layerB] &= ~(1u << layerA);
+    }
+}
+
+void SweepAndPrune::Set(int proxy, float x, float y, float width, float height) {
+    float halfWidth = width * 0.5f + MARGIN;
+    float halfHeight = height * 0.5f + MARGIN;
+    minX[proxy] = x - halfWidth;
+    maxX[proxy] = x + halfWidth;
+    minY[proxy] = y - halfHeight;
+    maxY[proxy] = y + halfHeight;
+    enabled[proxy] = true;
+}
+
+void SweepAndPrune::Sort() {
+    swaps = 0;
+    if (added) {
+        // new proxies can land anywhere, a full sort is cheaper than inserting them
+        std::sort(order.begin(), order.end(), [&](int a, int b) { return minX[a] < minX[b]; });
+        added = false;
+        return;
+    }
+    // insertion sort, close to linear on last step's order
+    for (size_t i = 1; i < order.size(); i++) {
+        int proxy = order[i];
+        float key = minX[proxy];
+        size_t j = i;
+        while (j > 0 && minX[order[j - 1]] > key) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = proxy;
+        swaps += i - j;
+    }
+}
+
+void SweepAndPrune::FindPairs(std::vector<OverlapPair>& out) {
+    Sort();
+    for (int layer = 0; layer < MAX_LAYERS; layer++) {
+        active[layer].clear();
+    }
+    for (int proxy : order) {
+        if (!enabled[proxy]) {
+            continue;
+        }
+        int layer = layers[proxy];
+        for (int other = 0; other < MAX_LAYERS; other++) {
+            if (!(collides[layer] & (1u << other))) {
+                continue;
+            }
+            std::vector<int>& list = active[other];
+            for (size_t i = 0; i < list.size();) {
+                int passed = list[i];
+                if (maxX[passed] < minX[proxy]) {
+                    // everything after this starts further right, so it's done
+                    list[i] = list.back();
+                    list.pop_back();
+                    continue;
+                }
+                if (minY[passed] <= maxY[proxy] && minY[proxy] <= maxY[passed]) {
+                    OverlapPair pair;
+                    pair.first = passed;
+                    pair.second = proxy;
+                    out.push_back(pair);
+                }
+                i++;
+            }
+        }
+        if (collides[layer]) {
+            active[layer].push_back(proxy);
+        }
+    }
+}
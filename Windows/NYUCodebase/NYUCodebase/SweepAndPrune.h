@@ -0,0 +1,75 @@
+#ifndef SWEEPANDPRUNE_H
+#define SWEEPANDPRUNE_H
+
+#include <vector>
+
+// two proxies whose boxes overlap, first entered the sweep before second
+struct OverlapPair {
+	int first;
+	int second;
+};
+
+// Broadphase for entity against entity collision. Every entity has a proxy
+// holding its box, and the proxies are kept sorted by the box's left edge.
+// Levels are long strips and things move a little each step, so the order
+// barely changes between steps and an insertion sort puts it right in about
+// one pass. A sweep along x then only compares boxes whose x ranges overlap,
+// and only between layers that were told they collide (enemies against the
+// player and barriers, not against each other).
+//
+// Boxes are padded by MARGIN, so the pairs found are a superset of the ones
+// Entity::CollidesWith accepts; that test still has the last word.
+class SweepAndPrune {
+public:
+	static const int MAX_LAYERS = 8;
+	static const float MARGIN;
+
+	// drops every proxy, keeps the storage and the layer rules
+	void Clear();
+
+	// a disabled proxy in layer, id is the caller's, e.g. an enemy's index
+	int Add(int layer, int id);
+
+	// pairs are only looked for between layers allowed to collide
+	void SetCollides(int layerA, int layerB, bool collides);
+
+	// the box centred on (x, y) and enables the proxy
+	void Set(int proxy, float x, float y, float width, float height);
+
+	// a disabled proxy keeps its place in the order but is never paired
+	void Disable(int proxy) { enabled[proxy] = false; }
+
+	int Layer(int proxy) const { return layers[proxy]; }
+	int Id(int proxy) const { return ids[proxy]; }
+	int Count() const { return (int)ids.size(); }
+
+	// re-sorts and appends every overlapping pair to out
+	void FindPairs(std::vector<OverlapPair>& out);
+
+	// swaps the last FindPairs' sort needed, about 0 when little moved
+	long long LastSwaps() const { return swaps; }
+
+private:
+	void Sort();
+
+	// proxies were added since the last sort, so the order may be far off
+	bool added = false;
+
+	std::vector<float> minX;
+	std::vector<float> maxX;
+	std::vector<float> minY;
+	std::vector<float> maxY;
+	std::vector<int> layers;
+	std::vector<int> ids;
+	std::vector<bool> enabled;
+	// proxies by minX
+	std::vector<int> order;
+	// the layers each layer collides with, one bit per layer
+	unsigned int collides[MAX_LAYERS] = {};
+
+	// proxies per layer the sweep has passed that may still overlap
+	std::vector<int> active[MAX_LAYERS];
+	long long swaps = 0;
+};
+
+#endif
@@ -0,0 +1,111 @@
+#include "TextCache.h"
+#include "RenderState.h"
+#include "glm/gtc/matrix_transform.hpp"
+#include <algorithm>
+#include <vector>
+
+// frames an unused string stays cached
+static const int TEXT_CACHE_FRAMES = 600;
+
+static void BuildGlyph(const SpriteSheet& font, char c, int index, float size, float spacing, QuadVertex* out) {
+    int spriteIndex = (unsigned char)c;
+    UVRect glyph = font.HasFrame(spriteIndex) ? font.Frame(spriteIndex) : UVRect{ 0.0f, 0.0f, 0.0f, 0.0f };
+    float left = ((size + spacing) * index) + (-0.5f * size);
+    float right = ((size + spacing) * index) + (0.5f * size);
+    GLushort u0 = PackUnit(glyph.left);
+    GLushort u1 = PackUnit(glyph.right);
+    GLushort v0 = PackUnit(glyph.top);
+    GLushort v1 = PackUnit(glyph.bottom);
+    out[0] = { left, 0.5f * size, u0, v0 };
+    out[1] = { left, -0.5f * size, u0, v1 };
+    out[2] = { right, -0.5f * size, u1, v1 };
+    out[3] = { right, 0.5f * size, u1, v0 };
+}
+
+TextMesh::TextMesh() : mesh(QUAD_VERTEX), size(0.0f), spacing(0.0f), fontRegion{ 0.0f, 0.0f, 0.0f, 0.0f },
+    capacity(0), uploadedGlyphs(0) {}
+
+void TextMesh::Set(const SpriteSheet& font, const std::string& text_, float size_, float spacing_) {
+    int length = (int)text_.size();
+    bool relayout = size_ != size || spacing_ != spacing || length > capacity || !(font.region == fontRegion);
+    if (!relayout && text_ == text) {
+        return;
+    }
+    if (length > capacity) {
+        capacity = std::max(length, 16);
+        mesh.SetVertices(NULL, capacity * 4 * sizeof(QuadVertex), GL_DYNAMIC_DRAW);
+        mesh.UseQuadIndices(capacity);
+    }
+
+    // upload each run of glyphs that differ from what's in the buffer
+    std::vector<QuadVertex> run;
+    int start = -1;
+    for (int i = 0; i <= length; i++) {
+        bool changed = i < length && (relayout || i >= (int)text.size() || text[i] != text_[i]);
+        if (changed) {
+            if (start < 0) {
+                start = i;
+                run.clear();
+            }
+            run.resize(run.size() + 4);
+            BuildGlyph(font, text_[i], i, size_, spacing_, &run[run.size() - 4]);
+        }
+        else if (start >= 0) {
+            mesh.UpdateVertices(start * 4 * sizeof(QuadVertex), run.data(), run.size() * sizeof(QuadVertex));
+            uploadedGlyphs += i - start;
+            start = -1;
+        }
+    }
+    text = text_;
+    size = size_;
+    spacing = spacing_;
+    fontRegion = font.region;
+}
+
+void TextMesh::Draw(ShaderProgram& program, const SpriteSheet& font, float x, float y) {
+    if (text.empty()) {
+        return;
+    }
+    program.SetModelMatrix(glm::translate(glm::mat4(1.0f), glm::vec3(x, y, 0.0f)));
+    mesh.Bind(program);
+    renderState.BindTexture(font.textureID);
+    mesh.DrawQuads(0, (int)text.size());
+    mesh.Unbind();
+}
+
+TextMesh& TextCache::Get(const SpriteSheet& font, const std::string& text, float size, float spacing) {
+    // only lays out again if the font moved
+    return Use(entries[std::make_tuple(text, size, spacing)], font, text, size, spacing);
+}
+
+TextMesh& TextCache::Get(int slot, const SpriteSheet& font, const std::string& text, float size, float spacing) {
+    // the slot's mesh is updated in place, only changed glyphs are sent
+    return Use(slots[slot], font, text, size, spacing);
+}
+
+TextMesh& TextCache::Use(Entry& entry, const SpriteSheet& font, const std::string& text, float size, float spacing) {
+    if (!entry.mesh) {
+        entry.mesh.reset(new TextMesh());
+    }
+    entry.mesh->Set(font, text, size, spacing);
+    entry.lastUsed = frame;
+    return *entry.mesh;
+}
+
+template <typename Map>
+static void DropUnused(Map& entries, int frame) {
+    for (auto i = entries.begin(); i != entries.end();) {
+        if (frame - i->second.lastUsed > TEXT_CACHE_FRAMES) {
+            i = entries.erase(i);
+        }
+        else {
+            ++i;
+        }
+    }
+}
+
+void TextCache::EndFrame() {
+    frame++;
+    DropUnused(entries, frame);
+    DropUnused(slots, frame);
+}
@@ -0,0 +1,67 @@
+#ifndef TEXTCACHE_H
+#define TEXTCACHE_H
+
+#include "glhelper.h"
+#include "ShaderProgram.h"
+#include "RenderBackend.h"
+#include "SpriteSheet.h"
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+
+// A line of text laid out as glyph quads from a font sheet, kept in
+// its own vertex buffer. Changing the text re-uploads only the glyphs that
+// differ, so a counter that ticks every frame sends a character or two.
+class TextMesh {
+public:
+	TextMesh();
+
+	// the font is a sheet with a frame for each character code
+	void Set(const SpriteSheet& font, const std::string& text_, float size_, float spacing_);
+
+	// draws with the first glyph centred on (x, y)
+	void Draw(ShaderProgram& program, const SpriteSheet& font, float x, float y);
+
+	// glyphs uploaded by the Sets so far
+	int UploadedGlyphs() const { return uploadedGlyphs; }
+
+private:
+	VertexArray mesh;
+	std::string text;
+	float size;
+	float spacing;
+	UVRect fontRegion;
+	int capacity;
+	int uploadedGlyphs;
+};
+
+// Text meshes for strings drawn every frame. Fixed text is keyed by the
+// string and its size and spacing, so a menu lays its text out once. Text
+// that changes, like a timer, goes through a slot the caller picks instead,
+// which keeps one mesh and re-uploads only the glyphs that changed. Entries
+// that haven't been drawn for a while are dropped.
+class TextCache {
+public:
+	TextMesh& Get(const SpriteSheet& font, const std::string& text, float size, float spacing);
+	TextMesh& Get(int slot, const SpriteSheet& font, const std::string& text, float size, float spacing);
+
+	// call once per rendered frame
+	void EndFrame();
+
+	size_t Size() const { return entries.size() + slots.size(); }
+
+private:
+	struct Entry {
+		std::unique_ptr<TextMesh> mesh;
+		int lastUsed = 0;
+	};
+
+	TextMesh& Use(Entry& entry, const SpriteSheet& font, const std::string& text, float size, float spacing);
+
+	std::map<std::tuple<std::string, float, float>, Entry> entries;
+	std::map<int, Entry> slots;
+	int frame = 0;
+};
+
+#endif
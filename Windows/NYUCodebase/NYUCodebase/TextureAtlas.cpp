@@ -0,0 +1,127 @@
+#include "TextureAtlas.h"
+#include "RenderState.h"
+#include "stb_image.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+// texels left between sheets. Each sheet's edge texels are copied out into
+// its half of the gap, so a packed UV that rounds a little past a sheet's
+// edge still reads that sheet's own colour, not its neighbour's
+static const int PADDING = 2;
+
+static int NextPowerOfTwo(int value) {
+    int power = 1;
+    while (power < value) {
+        power *= 2;
+    }
+    return power;
+}
+
+TextureAtlas::TextureAtlas() : texture(0), width(0), height(0) {}
+
+TextureAtlas::~TextureAtlas() {
+    if (texture != 0) {
+        renderState.ForgetTexture(texture);
+        glDeleteTextures(1, &texture);
+    }
+}
+
+int TextureAtlas::Add(const char *filePath, int x, int y) {
+    Image image;
+    image.spriteCountX = x;
+    image.spriteCountY = y;
+    int comp;
+    unsigned char* data = stbi_load(filePath, &image.width, &image.height, &comp, STBI_rgb_alpha);
+    if (data == NULL) {
+        // left empty, its frames come out as nothing
+        std::cout << "Unable to load image. Make sure the path is correct\n";
+        image.width = image.height = 0;
+    }
+    else {
+        image.pixels.assign(data, data + image.width * image.height * 4);
+        stbi_image_free(data);
+    }
+    images.push_back(std::move(image));
+    return (int)images.size() - 1;
+}
+
+void TextureAtlas::Pack() {
+    // shelves of images, tallest first, in a power of two wide texture
+    std::vector<int> order(images.size());
+    int widest = 1;
+    for (size_t i = 0; i < images.size(); i++) {
+        order[i] = (int)i;
+        widest = std::max(widest, images[i].width);
+    }
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return images[a].height > images[b].height;
+    });
+    width = NextPowerOfTwo(widest);
+    int shelfX = 0;
+    int shelfY = 0;
+    int shelfHeight = 0;
+    for (int index : order) {
+        Image& image = images[index];
+        if (shelfX > 0 && shelfX + PADDING + image.width > width) {
+            shelfY += shelfHeight + PADDING;
+            shelfX = 0;
+            shelfHeight = 0;
+        }
+        if (shelfX > 0) {
+            shelfX += PADDING;
+        }
+        image.x = shelfX;
+        image.y = shelfY;
+        shelfX += image.width;
+        shelfHeight = std::max(shelfHeight, image.height);
+    }
+    height = NextPowerOfTwo(std::max(shelfY + shelfHeight, 1));
+}
+
+void TextureAtlas::Build() {
+    Pack();
+    std::vector<unsigned char> pixels((size_t)width * height * 4, 0);
+    const int extrude = PADDING / 2;
+    for (const Image& image : images) {
+        if (image.width == 0 || image.height == 0) {
+            continue;
+        }
+        int top = std::max(image.y - extrude, 0);
+        int bottom = std::min(image.y + image.height + extrude, height);
+        int left = std::max(image.x - extrude, 0);
+        int right = std::min(image.x + image.width + extrude, width);
+        for (int y = top; y < bottom; y++) {
+            int row = std::min(std::max(y - image.y, 0), image.height - 1);
+            for (int x = left; x < right; x++) {
+                int column = std::min(std::max(x - image.x, 0), image.width - 1);
+                memcpy(&pixels[((size_t)y * width + x) * 4], &image.pixels[((size_t)row * image.width + column) * 4], 4);
+            }
+        }
+    }
+
+    if (texture == 0) {
+        glGenTextures(1, &texture);
+    }
+    renderState.BindTexture(texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    // nearest sampling, plus the padding, never reads a neighbouring sheet
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    sheets.clear();
+    for (const Image& image : images) {
+        UVRect region;
+        region.left = (float)image.x / (float)width;
+        region.top = (float)image.y / (float)height;
+        region.right = (float)(image.x + image.width) / (float)width;
+        region.bottom = (float)(image.y + image.height) / (float)height;
+        sheets.push_back(SpriteSheet(texture, image.spriteCountX, image.spriteCountY, region));
+    }
+    // the atlas holds its own copy now
+    for (Image& image : images) {
+        std::vector<unsigned char>().swap(image.pixels);
+    }
+}
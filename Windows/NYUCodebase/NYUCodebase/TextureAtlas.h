@@ -0,0 +1,54 @@
+#ifndef TEXTUREATLAS_H
+#define TEXTUREATLAS_H
+
+#include "glhelper.h"
+#include "SpriteSheet.h"
+#include <vector>
+
+// Packs sprite sheets into one texture at load time, so tiles, sprites and
+// text can all be drawn without switching textures. Each sheet comes back
+// with its frames pointing at its part of the atlas. Sheets are kept a couple
+// of texels apart so rounded UVs don't pick up a neighbour's edge.
+class TextureAtlas {
+public:
+	TextureAtlas();
+	~TextureAtlas();
+
+	TextureAtlas(const TextureAtlas&) = delete;
+	TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+	// reads an image cut into x by y frames, returns its index for Sheet
+	int Add(const char *filePath, int x, int y);
+
+	// packs everything added into the texture, call once after the last Add
+	void Build();
+
+	// valid after Build
+	const SpriteSheet& Sheet(int index) const { return sheets[index]; }
+
+	GLuint TextureID() const { return texture; }
+	int Width() const { return width; }
+	int Height() const { return height; }
+
+private:
+	struct Image {
+		std::vector<unsigned char> pixels;
+		int width = 0;
+		int height = 0;
+		int spriteCountX = 0;
+		int spriteCountY = 0;
+		// top left corner in the atlas
+		int x = 0;
+		int y = 0;
+	};
+
+	void Pack();
+
+	std::vector<Image> images;
+	std::vector<SpriteSheet> sheets;
+	GLuint texture;
+	int width;
+	int height;
+};
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef TILEGRID_H
+#define TILEGRID_H
+
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// Tile ids for a whole layer in one allocation, split into square chunks of
+// CHUNK_SIZE x CHUNK_SIZE cells. Each chunk is stored row-major in one
+// contiguous block so code that works a chunk at a time (rendering, region
+// queries) stays in a few cache lines; chunks on the right and bottom edges
+// are padded with empty cells.
+//
+// Cell is the unsigned integer type a tile id is stored in (unsigned char for
+// tilesets of up to 255 tiles, unsigned short otherwise); its largest value
+// marks an empty cell.
+//
+// The cells normally live in the grid's own vector, but Attach() can point
+// the grid at cells stored elsewhere in the same layout (a mapped level file).
+template <typename Cell, int CHUNK_SHIFT = 4>
+class TileGrid {
+public:
+	static constexpr Cell EMPTY = std::numeric_limits<Cell>::max();
+	static const int SHIFT = CHUNK_SHIFT;
+	static const int CHUNK_SIZE = 1 << CHUNK_SHIFT;
+	static const int CHUNK_CELLS = CHUNK_SIZE * CHUNK_SIZE;
+
+	TileGrid() {}
+	TileGrid(int width_, int height_) { Resize(width_, height_); }
+
+	TileGrid(const TileGrid& other) { *this = other; }
+
+	TileGrid& operator=(const TileGrid& other) {
+		width = other.width;
+		height = other.height;
+		chunksX = other.chunksX;
+		chunksY = other.chunksY;
+		storage = other.storage;
+		cells = other.IsAttached() ? other.cells : storage.data();
+		return *this;
+	}
+
+	// trades cells with another grid without copying them; attached grids
+	// stay attached
+	void Swap(TileGrid& other) {
+		std::swap(width, other.width);
+		std::swap(height, other.height);
+		std::swap(chunksX, other.chunksX);
+		std::swap(chunksY, other.chunksY);
+		std::swap(cells, other.cells);
+		storage.swap(other.storage);
+	}
+
+	void Resize(int width_, int height_) {
+		SetSize(width_, height_);
+		storage.assign(CellCount(), EMPTY);
+		cells = storage.data();
+	}
+
+	// use cells laid out like this grid's storage that live somewhere else;
+	// that memory has to outlive the grid
+	void Attach(Cell* external, int width_, int height_) {
+		SetSize(width_, height_);
+		std::vector<Cell>().swap(storage);
+		cells = external;
+	}
+
+	bool IsAttached() const { return cells != storage.data(); }
+
+	int Width() const { return width; }
+	int Height() const { return height; }
+	int ChunksX() const { return chunksX; }
+	int ChunksY() const { return chunksY; }
+
+	bool InBounds(int x, int y) const {
+		return x >= 0 && x < width && y >= 0 && y < height;
+	}
+
+	// unchecked access, the caller makes sure x and y are in bounds
+	Cell& operator()(int x, int y) { return cells[Index(x, y)]; }
+	Cell operator()(int x, int y) const { return cells[Index(x, y)]; }
+
+	// checked access, cells outside the grid read as empty
+	Cell Get(int x, int y) const { return InBounds(x, y) ? (*this)(x, y) : EMPTY; }
+
+	void Set(int x, int y, Cell value) {
+		if (InBounds(x, y)) {
+			(*this)(x, y) = value;
+		}
+	}
+
+	// the CHUNK_CELLS cells of a chunk, row-major
+	const Cell* Chunk(int chunkX, int chunkY) const {
+		return &cells[((size_t)chunkY * chunksX + chunkX) * CHUNK_CELLS];
+	}
+
+	// all cells in storage order, including edge padding
+	Cell* Data() { return cells; }
+	const Cell* Data() const { return cells; }
+	size_t CellCount() const { return (size_t)chunksX * chunksY * CHUNK_CELLS; }
+
+private:
+	void SetSize(int width_, int height_) {
+		width = width_;
+		height = height_;
+		chunksX = (width + CHUNK_SIZE - 1) >> CHUNK_SHIFT;
+		chunksY = (height + CHUNK_SIZE - 1) >> CHUNK_SHIFT;
+	}
+
+	size_t Index(int x, int y) const {
+		size_t chunk = (size_t)(y >> CHUNK_SHIFT) * chunksX + (x >> CHUNK_SHIFT);
+		return chunk * CHUNK_CELLS + ((y & (CHUNK_SIZE - 1)) << CHUNK_SHIFT) + (x & (CHUNK_SIZE - 1));
+	}
+
+	int width = 0;
+	int height = 0;
+	int chunksX = 0;
+	int chunksY = 0;
+	Cell* cells = nullptr;
+	std::vector<Cell> storage;
+};
+
+template <typename Cell, int CHUNK_SHIFT>
+constexpr Cell TileGrid<Cell, CHUNK_SHIFT>::EMPTY;
+
+#endif
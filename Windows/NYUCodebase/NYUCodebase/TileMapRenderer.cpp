@@ -0,0 +1,124 @@
+#include "TileMapRenderer.h"
+#include "RenderState.h"
+#include "helper.h"
+#include <algorithm>
+
+// the texture is GL_R16UI
+static_assert(sizeof(TileID) == 2, "TileMapRenderer uploads 16 bit tile ids");
+
+TileMapRenderer::TileMapRenderer() : loaded(false), tilesUniform(-1), sheetSizeUniform(-1), sheetRectUniform(-1),
+    texture(0), textureWidth(0), textureHeight(0), quad(FLOAT_VERTEX) {}
+
+TileMapRenderer::~TileMapRenderer() {
+    Clear();
+    if (loaded) {
+        program.Cleanup();
+    }
+}
+
+bool TileMapRenderer::Load(const char *vertexShaderFile, const char *fragmentShaderFile, const glm::mat4& projection) {
+    program.Load(vertexShaderFile, fragmentShaderFile);
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program.programID, GL_LINK_STATUS, &linked);
+    if (linked == GL_FALSE) {
+        program.Cleanup();
+        return false;
+    }
+    tilesUniform = glGetUniformLocation(program.programID, "tiles");
+    sheetSizeUniform = glGetUniformLocation(program.programID, "sheetSize");
+    sheetRectUniform = glGetUniformLocation(program.programID, "sheetRect");
+    program.SetProjectionMatrix(projection);
+    program.SetModelMatrix(glm::mat4(1.0f));
+    // the sheet stays on texture unit 0, the tiles go on 1
+    renderState.Uniform1i(tilesUniform, 1);
+    loaded = true;
+    return true;
+}
+
+void TileMapRenderer::Clear() {
+    if (texture != 0) {
+        renderState.ForgetTexture(texture);
+        glDeleteTextures(1, &texture);
+        texture = 0;
+    }
+    textureWidth = textureHeight = 0;
+    revisions.clear();
+}
+
+bool TileMapRenderer::Update(const FlareMap& map) {
+    if (!loaded) {
+        return false;
+    }
+    const int chunkSize = TileGrid<TileID>::CHUNK_SIZE;
+    int chunksX = map.mapData.ChunksX();
+    int chunksY = map.mapData.ChunksY();
+    // whole chunks are uploaded, so the texture includes the grid's padding
+    int width = chunksX * chunkSize;
+    int height = chunksY * chunkSize;
+    if (width != textureWidth || height != textureHeight || texture == 0) {
+        GLint maxSize = 0;
+        glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+        if (width > maxSize || height > maxSize) {
+            return false;
+        }
+        if (texture == 0) {
+            glGenTextures(1, &texture);
+        }
+        renderState.BindTexture(texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R16UI, width, height, 0, GL_RED_INTEGER, GL_UNSIGNED_SHORT, NULL);
+        // integer textures can't be filtered
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        textureWidth = width;
+        textureHeight = height;
+        revisions.assign(chunksX * chunksY, 0);
+    }
+    else {
+        renderState.BindTexture(texture);
+    }
+
+    // chunks are stored row by row, the same layout as a 16x16 sub image
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+    for (int cy = 0; cy < chunksY; cy++) {
+        for (int cx = 0; cx < chunksX; cx++) {
+            unsigned int revision = map.ChunkAt(cx, cy).revision;
+            if (revisions[cy * chunksX + cx] == revision) {
+                continue;
+            }
+            glTexSubImage2D(GL_TEXTURE_2D, 0, cx * chunkSize, cy * chunkSize, chunkSize, chunkSize,
+                GL_RED_INTEGER, GL_UNSIGNED_SHORT, map.mapData.Chunk(cx, cy));
+            revisions[cy * chunksX + cx] = revision;
+        }
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    return true;
+}
+
+void TileMapRenderer::Draw(const FlareMap& map, const SpriteSheet& sheet, const glm::mat4& viewMatrix, const WorldRect& view) {
+    // the quad covers the part of the level on screen, in world units and in tiles
+    float left = std::max(view.left, 0.0f);
+    float right = std::min(view.right, map.mapWidth * TILE_SIZE);
+    float top = std::min(view.top, 0.0f);
+    float bottom = std::max(view.bottom, map.mapHeight * -TILE_SIZE);
+    if (left >= right || bottom >= top) {
+        return;
+    }
+    FloatVertex corners[] = {
+        { left, top, left / TILE_SIZE, -top / TILE_SIZE },
+        { left, bottom, left / TILE_SIZE, -bottom / TILE_SIZE },
+        { right, bottom, right / TILE_SIZE, -bottom / TILE_SIZE },
+        { right, top, right / TILE_SIZE, -top / TILE_SIZE }
+    };
+    program.SetViewMatrix(viewMatrix);
+    renderState.Uniform2f(sheetSizeUniform, (float)sheet.spriteCountX, (float)sheet.spriteCountY);
+    const UVRect& region = sheet.region;
+    renderState.Uniform4f(sheetRectUniform, region.left, region.top, region.right - region.left, region.bottom - region.top);
+
+    quad.StreamVertices(corners, sizeof(corners));
+    quad.UseQuadIndices(1);
+    quad.Bind(program);
+    renderState.BindTexture(texture, 1);
+    renderState.BindTexture(sheet.textureID, 0);
+    quad.DrawQuads(0, 1);
+    quad.Unbind();
+}
@@ -0,0 +1,53 @@
+#ifndef TILEMAPRENDERER_H
+#define TILEMAPRENDERER_H
+
+#include "glhelper.h"
+#include "FlareMap.h"
+#include "SpriteSheet.h"
+#include "ShaderProgram.h"
+#include "RenderBackend.h"
+#include "glm/mat4x4.hpp"
+#include <vector>
+
+// Draws a level's tiles as a single quad over the visible part of the level.
+// The tile ids live in an integer texture, one texel per cell, and the
+// fragment shader looks each pixel's tile up in it and samples the sheet, so
+// the cost doesn't depend on how many tiles there are. Tile edits upload
+// just the chunks that changed. Needs GLSL 1.30.
+class TileMapRenderer {
+public:
+	TileMapRenderer();
+	~TileMapRenderer();
+
+	TileMapRenderer(const TileMapRenderer&) = delete;
+	TileMapRenderer& operator=(const TileMapRenderer&) = delete;
+
+	// false if the shaders don't build on this GL
+	bool Load(const char *vertexShaderFile, const char *fragmentShaderFile, const glm::mat4& projection);
+
+	// brings the tile texture in line with the map, false if the level is
+	// larger than the GL's biggest texture
+	bool Update(const FlareMap& map);
+
+	void Draw(const FlareMap& map, const SpriteSheet& sheet, const glm::mat4& viewMatrix, const WorldRect& view);
+
+	// frees the tile texture, the next Update uploads everything
+	void Clear();
+
+private:
+	ShaderProgram program;
+	bool loaded;
+	GLint tilesUniform;
+	GLint sheetSizeUniform;
+	GLint sheetRectUniform;
+
+	GLuint texture;
+	int textureWidth;
+	int textureHeight;
+	// revision of every chunk as last uploaded
+	std::vector<unsigned int> revisions;
+
+	VertexArray quad;
+};
+
+#endif
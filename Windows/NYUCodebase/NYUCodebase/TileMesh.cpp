@@ -0,0 +1,170 @@
+#include "TileMesh.h"
+#include "RenderState.h"
+#include "helper.h"
+#include "glm/gtc/matrix_transform.hpp"
+#include <algorithm>
+
+TileMesh::TileMesh() : mesh(TILE_VERTEX), built(false), quadCount(0), chunksX(0), chunksY(0) {}
+
+TileMesh::~TileMesh() {
+    Clear();
+}
+
+void TileMesh::Clear() {
+    mesh.Destroy();
+    built = false;
+    quadCount = 0;
+    chunks.clear();
+}
+
+void TileMesh::Update(const FlareMap& map, const SpriteSheet& sheet_) {
+    if (!built || map.mapData.ChunksX() != chunksX || map.mapData.ChunksY() != chunksY ||
+        sheet_.spriteCountX != sheet.spriteCountX || sheet_.spriteCountY != sheet.spriteCountY ||
+        !(sheet_.region == sheet.region)) {
+        chunksX = map.mapData.ChunksX();
+        chunksY = map.mapData.ChunksY();
+        sheet = sheet_;
+        Rebuild(map);
+        return;
+    }
+
+    // revisions are unique across levels, so a new level shows up as every
+    // chunk having changed
+    std::vector<TileVertex> vertices;
+    for (int cy = 0; cy < chunksY; cy++) {
+        for (int cx = 0; cx < chunksX; cx++) {
+            ChunkMesh& chunk = chunks[cy * chunksX + cx];
+            const ChunkSummary& summary = map.ChunkAt(cx, cy);
+            if (chunk.revision == summary.revision) {
+                continue;
+            }
+            vertices.clear();
+            BuildChunk(map, cx, cy, vertices);
+            if ((int)vertices.size() != chunk.count * 4) {
+                // tiles were added or removed, the chunks after this one move
+                Rebuild(map);
+                return;
+            }
+            mesh.UpdateVertices(chunk.first * 4 * sizeof(TileVertex),
+                vertices.data(), vertices.size() * sizeof(TileVertex));
+            chunk.revision = summary.revision;
+        }
+    }
+}
+
+void TileMesh::Rebuild(const FlareMap& map) {
+    chunks.assign(chunksX * chunksY, ChunkMesh());
+    std::vector<TileVertex> vertices;
+    for (int cy = 0; cy < chunksY; cy++) {
+        for (int cx = 0; cx < chunksX; cx++) {
+            ChunkMesh& chunk = chunks[cy * chunksX + cx];
+            chunk.first = (int)(vertices.size() / 4);
+            BuildChunk(map, cx, cy, vertices);
+            chunk.count = (int)(vertices.size() / 4) - chunk.first;
+            chunk.revision = map.ChunkAt(cx, cy).revision;
+        }
+    }
+    quadCount = (int)(vertices.size() / 4);
+
+    mesh.SetVertices(vertices.data(), vertices.size() * sizeof(TileVertex));
+    mesh.UseQuadIndices(quadCount);
+    built = true;
+}
+
+void TileMesh::BuildChunk(const FlareMap& map, int chunkX, int chunkY, std::vector<TileVertex>& out) const {
+    if (map.ChunkAt(chunkX, chunkY).Empty()) {
+        return;
+    }
+    const int chunkSize = TileGrid<TileID>::CHUNK_SIZE;
+    // positions are relative to the chunk's section
+    int originX = chunkX / SECTION_CHUNKS * SECTION_CHUNKS * chunkSize;
+    int originY = chunkY / SECTION_CHUNKS * SECTION_CHUNKS * chunkSize;
+    int endY = std::min((chunkY + 1) * chunkSize, map.mapHeight);
+    int endX = std::min((chunkX + 1) * chunkSize, map.mapWidth);
+    for (int gridY = chunkY * chunkSize; gridY < endY; gridY++) {
+        for (int gridX = chunkX * chunkSize; gridX < endX; gridX++) {
+            TileID tile = map.mapData(gridX, gridY);
+            // empty cells and ids the sheet doesn't have
+            if (!sheet.HasFrame(tile)) {
+                continue;
+            }
+            const UVRect& frame = sheet.Frame(tile);
+            GLushort left = PackUnit(frame.left);
+            GLushort right = PackUnit(frame.right);
+            GLushort top = PackUnit(frame.top);
+            GLushort bottom = PackUnit(frame.bottom);
+            int x = gridX - originX;
+            int y = gridY - originY;
+            out.push_back({ (GLshort)x, (GLshort)-y, left, top });
+            out.push_back({ (GLshort)x, (GLshort)(-y - 1), left, bottom });
+            out.push_back({ (GLshort)(x + 1), (GLshort)(-y - 1), right, bottom });
+            out.push_back({ (GLshort)(x + 1), (GLshort)-y, right, top });
+        }
+    }
+}
+
+void TileMesh::Draw(ShaderProgram& program, GLuint texture) {
+    if (quadCount == 0) {
+        return;
+    }
+    if (chunksX > SECTION_CHUNKS || chunksY > SECTION_CHUNKS) {
+        ChunkRange range;
+        range.maxX = chunksX - 1;
+        range.maxY = chunksY - 1;
+        Draw(program, texture, range);
+        return;
+    }
+    SetOrigin(program, 0, 0);
+    mesh.Bind(program);
+    renderState.BindTexture(texture);
+    mesh.DrawQuads(0, quadCount);
+    mesh.Unbind();
+}
+
+void TileMesh::Draw(ShaderProgram& program, GLuint texture, const ChunkRange& range) {
+    int minX = std::max(range.minX, 0);
+    int maxX = std::min(range.maxX, chunksX - 1);
+    int minY = std::max(range.minY, 0);
+    int maxY = std::min(range.maxY, chunksY - 1);
+    bool bound = false;
+    // one draw per section, each row of chunks in it is one run
+    for (int sy = minY / SECTION_CHUNKS; sy <= maxY / SECTION_CHUNKS && minX <= maxX; sy++) {
+        for (int sx = minX / SECTION_CHUNKS; sx <= maxX / SECTION_CHUNKS; sx++) {
+            int firstX = std::max(minX, sx * SECTION_CHUNKS);
+            int lastX = std::min(maxX, sx * SECTION_CHUNKS + SECTION_CHUNKS - 1);
+            int lastY = std::min(maxY, sy * SECTION_CHUNKS + SECTION_CHUNKS - 1);
+            runCounts.clear();
+            runOffsets.clear();
+            for (int cy = std::max(minY, sy * SECTION_CHUNKS); cy <= lastY; cy++) {
+                const ChunkMesh& first = chunks[cy * chunksX + firstX];
+                const ChunkMesh& last = chunks[cy * chunksX + lastX];
+                int quads = last.first + last.count - first.first;
+                if (quads > 0) {
+                    runCounts.push_back(quads * 6);
+                    runOffsets.push_back((const void*)((size_t)first.first * 6 * sizeof(GLuint)));
+                }
+            }
+            if (runCounts.empty()) {
+                continue;
+            }
+            SetOrigin(program, sx, sy);
+            if (!bound) {
+                mesh.Bind(program);
+                renderState.BindTexture(texture);
+                bound = true;
+            }
+            mesh.MultiDrawIndexed(GL_TRIANGLES, runCounts.data(), runOffsets.data(), (GLsizei)runCounts.size());
+        }
+    }
+    if (bound) {
+        mesh.Unbind();
+    }
+}
+
+void TileMesh::SetOrigin(ShaderProgram& program, int sectionX, int sectionY) const {
+    // the vertices count whole tiles from the section's top left corner
+    float tiles = (float)(SECTION_CHUNKS * TileGrid<TileID>::CHUNK_SIZE);
+    glm::mat4 modelMatrix = glm::scale(glm::mat4(1.0f), glm::vec3(TILE_SIZE, TILE_SIZE, 1.0f));
+    modelMatrix = glm::translate(modelMatrix, glm::vec3(sectionX * tiles, -sectionY * tiles, 0.0f));
+    program.SetModelMatrix(modelMatrix);
+}
@@ -0,0 +1,72 @@
+#ifndef TILEMESH_H
+#define TILEMESH_H
+
+#include "glhelper.h"
+#include "FlareMap.h"
+#include "SpriteSheet.h"
+#include "ShaderProgram.h"
+#include "RenderBackend.h"
+#include <vector>
+
+// The tile geometry of a level kept in a GPU buffer. It is built when a level
+// is first drawn, and after that only the chunks whose tiles changed are
+// rebuilt, so drawing the tiles is one buffer bind and one draw call.
+//
+// Positions are packed into GLshorts relative to the section of
+// SECTION_CHUNKS x SECTION_CHUNKS chunks they are in, and each section is
+// drawn with its origin in the model matrix, so levels of any size are drawn
+// whole. Levels up to one section across, which is all of the game's, still
+// take a single draw.
+class TileMesh {
+public:
+	TileMesh();
+	~TileMesh();
+
+	TileMesh(const TileMesh&) = delete;
+	TileMesh& operator=(const TileMesh&) = delete;
+
+	// brings the buffer in line with the map's tiles
+	void Update(const FlareMap& map, const SpriteSheet& sheet);
+
+	// both Draws set the model matrix
+	void Draw(ShaderProgram& program, GLuint texture);
+
+	// draws only the given chunks, each row of chunks is one contiguous run
+	// of the buffer so this is still a single draw call
+	void Draw(ShaderProgram& program, GLuint texture, const ChunkRange& range);
+
+	// frees the buffer, the next Update rebuilds everything
+	void Clear();
+
+	int QuadCount() const { return quadCount; }
+
+	// 16384 tiles, a section's far edge still fits a GLshort
+	static const int SECTION_CHUNKS = 1024;
+
+private:
+	// a chunk's run of quads in the buffer
+	struct ChunkMesh {
+		int first = 0;
+		int count = 0;
+		unsigned int revision = 0;
+	};
+
+	void Rebuild(const FlareMap& map);
+	void BuildChunk(const FlareMap& map, int chunkX, int chunkY, std::vector<TileVertex>& out) const;
+	void SetOrigin(ShaderProgram& program, int sectionX, int sectionY) const;
+
+	VertexArray mesh;
+	bool built;
+	int quadCount;
+	int chunksX;
+	int chunksY;
+	// the sheet the buffer was built from
+	SpriteSheet sheet;
+	std::vector<ChunkMesh> chunks;
+
+	// reused by the culled Draw
+	std::vector<GLsizei> runCounts;
+	std::vector<const void*> runOffsets;
+};
+
+#endif
@@ -0,0 +1,162 @@
+#include "TileSweep.h"
+#include "helper.h"
+#include <algorithm>
+#include <cfloat>
+#include <math.h>
+
+// how far past a tile's face, in tiles, a box has to reach before it
+// overlaps the tile rather than touching it; covers the rounding of a
+// position placed flush against a face
+static const float TOUCH = 0.0001f;
+
+// TOUCH for positions up to tiles from the origin. The rounding grows with
+// the position, a few thousand tiles out it's already more than TOUCH
+static float Touch(float tiles) {
+    return std::max(TOUCH, fabsf(tiles) * 4.0f * FLT_EPSILON);
+}
+
+// the cells a position in tiles is at or after, and at or before. Clamped
+// so far off boxes still convert, and done by hand since without SSE4.1
+// floorf and ceilf are library calls
+static int FloorCell(float tiles) {
+    tiles = std::min(std::max(tiles, -1.0e8f), 1.0e8f);
+    int cell = (int)tiles;
+    return cell - (tiles < (float)cell);
+}
+
+static int CeilCell(float tiles) {
+    tiles = std::min(std::max(tiles, -1.0e8f), 1.0e8f);
+    int cell = (int)tiles;
+    return cell + (tiles > (float)cell);
+}
+
+// the cells from first to last the span low..high (in tiles) overlaps,
+// clamped to the size cells the map has
+static void Overlapped(float low, float high, float touch, int size, int* first, int* last) {
+    *first = std::max(FloorCell(low + touch), 0);
+    *last = std::min(CeilCell(high - touch) - 1, size - 1);
+}
+
+// flags of the solid tiles in row from column first to last
+static unsigned char SolidInRow(const FlareMap& map, int row, int first, int last) {
+    unsigned char flags = 0;
+    for (int column = first; column <= last; column++) {
+        unsigned char tile = map.TileFlags(column, row);
+        if (tile & TILE_SOLID) {
+            flags |= tile;
+        }
+    }
+    return flags;
+}
+
+static unsigned char SolidInColumn(const FlareMap& map, int column, int first, int last) {
+    unsigned char flags = 0;
+    for (int row = first; row <= last; row++) {
+        unsigned char tile = map.TileFlags(column, row);
+        if (tile & TILE_SOLID) {
+            flags |= tile;
+        }
+    }
+    return flags;
+}
+
+TileSweep SweepTiles(const FlareMap& map, float& x, float& y, float width, float height, float dx, float dy) {
+    TileSweep sweep;
+    int mapWidth = map.mapData.Width();
+    int mapHeight = map.mapData.Height();
+    int first;
+    int last;
+
+    // rows count down the screen, so in tiles y is negated
+    float top = (y + height * 0.5f) / -TILE_SIZE;
+    float bottom = (y - height * 0.5f) / -TILE_SIZE;
+    float rows = dy / -TILE_SIZE;
+    float left = (x - width * 0.5f) / TILE_SIZE;
+    float right = (x + width * 0.5f) / TILE_SIZE;
+    float touchY = Touch(std::max(fabsf(top), fabsf(bottom)) + fabsf(rows));
+    float touchX = Touch(std::max(fabsf(left), fabsf(right)) + fabsf(dx / TILE_SIZE));
+    int firstColumn;
+    int lastColumn;
+    Overlapped(left, right, touchX, mapWidth, &firstColumn, &lastColumn);
+    if (rows > 0.0f) {
+        // falling, each row is entered through its top face. A move ending
+        // within touch of a face stops on it, so the rounding of y += dy
+        // can't leave the box further in than the next sweep looks
+        first = std::max(CeilCell(bottom - touchY), 0);
+        last = std::min(CeilCell(bottom + rows + touchY) - 1, mapHeight - 1);
+        for (int row = first; row <= last && !sweep.normalY; row++) {
+            sweep.flagsY = SolidInRow(map, row, firstColumn, lastColumn);
+            if (sweep.flagsY) {
+                sweep.normalY = 1;
+                y = row * -TILE_SIZE + height * 0.5f;
+            }
+        }
+    }
+    else if (rows < 0.0f) {
+        // rising, each row is entered through its bottom face
+        first = std::min(FloorCell(top + touchY) - 1, mapHeight - 1);
+        last = std::max(FloorCell(top + rows - touchY), 0);
+        for (int row = first; row >= last && !sweep.normalY; row--) {
+            sweep.flagsY = SolidInRow(map, row, firstColumn, lastColumn);
+            if (sweep.flagsY) {
+                sweep.normalY = -1;
+                y = (row + 1) * -TILE_SIZE - height * 0.5f;
+            }
+        }
+    }
+    if (!sweep.normalY) {
+        y += dy;
+    }
+
+    float columns = dx / TILE_SIZE;
+    int firstRow;
+    int lastRow;
+    Overlapped((y + height * 0.5f) / -TILE_SIZE, (y - height * 0.5f) / -TILE_SIZE, touchY, mapHeight, &firstRow, &lastRow);
+    if (columns > 0.0f) {
+        first = std::max(CeilCell(right - touchX), 0);
+        last = std::min(CeilCell(right + columns + touchX) - 1, mapWidth - 1);
+        for (int column = first; column <= last && !sweep.normalX; column++) {
+            sweep.flagsX = SolidInColumn(map, column, firstRow, lastRow);
+            if (sweep.flagsX) {
+                sweep.normalX = -1;
+                x = column * TILE_SIZE - width * 0.5f;
+            }
+        }
+    }
+    else if (columns < 0.0f) {
+        first = std::min(FloorCell(left + touchX) - 1, mapWidth - 1);
+        last = std::max(FloorCell(left + columns - touchX), 0);
+        for (int column = first; column >= last && !sweep.normalX; column--) {
+            sweep.flagsX = SolidInColumn(map, column, firstRow, lastRow);
+            if (sweep.flagsX) {
+                sweep.normalX = 1;
+                x = (column + 1) * TILE_SIZE + width * 0.5f;
+            }
+        }
+    }
+    if (!sweep.normalX) {
+        x += dx;
+    }
+    return sweep;
+}
+
+// flags of the cell a point in tiles is in, 0 outside the map
+static unsigned char FlagsAt(const FlareMap& map, float column, float row) {
+    int gridX = FloorCell(column);
+    int gridY = FloorCell(row);
+    return map.mapData.InBounds(gridX, gridY) ? map.TileFlags(gridX, gridY) : 0;
+}
+
+unsigned char TilesAtFaces(const FlareMap& map, float x, float y, float width, float height) {
+    float column = x / TILE_SIZE;
+    float row = y / -TILE_SIZE;
+    float left = (x - width * 0.5f) / TILE_SIZE;
+    float right = (x + width * 0.5f) / TILE_SIZE;
+    float top = (y + height * 0.5f) / -TILE_SIZE;
+    float bottom = (y - height * 0.5f) / -TILE_SIZE;
+    float touchX = Touch(std::max(fabsf(left), fabsf(right)));
+    float touchY = Touch(std::max(fabsf(top), fabsf(bottom)));
+    // just past each face, so a tile the face is flush against counts
+    return FlagsAt(map, column, bottom + touchY) | FlagsAt(map, column, top - touchY) |
+        FlagsAt(map, left - touchX, row) | FlagsAt(map, right + touchX, row);
+}
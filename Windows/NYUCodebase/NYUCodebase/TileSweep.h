@@ -0,0 +1,32 @@
+#ifndef TILESWEEP_H
+#define TILESWEEP_H
+
+#include "FlareMap.h"
+
+// What a box ran into moving through a level's tiles.
+struct TileSweep {
+	// normals of the solid faces the box stopped against, 0 on an axis it
+	// moved freely on. normalY is 1 landing on a floor and -1 hitting a
+	// ceiling, normalX is 1 hitting a wall on the left and -1 on the right
+	int normalX = 0;
+	int normalY = 0;
+	// flags of the solid tiles stopped against on each axis
+	unsigned char flagsX = 0;
+	unsigned char flagsY = 0;
+};
+
+// Moves the box centred on (x, y) by (dx, dy): y first, then x from the
+// resolved y. Each axis walks the rows or columns the leading edge crosses
+// in order and stops flush against the first one with a solid tile under
+// the box, so no move is long enough to pass through a tile and the box is
+// never left overlapping one. Faces the box only touches don't count as
+// overlaps, so a box resting on a floor slides along it. Cells outside the
+// map are empty.
+TileSweep SweepTiles(const FlareMap& map, float& x, float& y, float width, float height, float dx, float dy);
+
+// flags of the tiles at the middle of each face of the box centred on
+// (x, y), a face resting against a tile counting as in it, e.g. the spikes
+// a player lands on. Tiles under only a corner of the box aren't included.
+unsigned char TilesAtFaces(const FlareMap& map, float x, float y, float width, float height);
+
+#endif
@@ -0,0 +1,21 @@
+#version 130
+uniform sampler2D diffuse;
+// one texel per tile holding its id, 65535 for empty cells
+uniform usampler2D tiles;
+// sprites across and down in the sheet
+uniform vec2 sheetSize;
+// the sheet's part of diffuse, left and top then width and height
+uniform vec4 sheetRect;
+varying vec2 texCoordVar;
+
+void main() {
+    ivec2 cell = min(ivec2(floor(texCoordVar)), textureSize(tiles, 0) - 1);
+    uint tile = texelFetch(tiles, cell, 0).r;
+    uint across = uint(sheetSize.x);
+    // empty cells, and ids past the end of the sheet
+    if (tile >= across * uint(sheetSize.y)) {
+        discard;
+    }
+    vec2 sprite = vec2(float(tile % across), float(tile / across));
+    gl_FragColor = texture2D(diffuse, sheetRect.xy + (sprite + fract(texCoordVar)) / sheetSize * sheetRect.zw);
+}
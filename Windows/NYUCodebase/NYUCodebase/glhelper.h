@@ -0,0 +1,14 @@
+#pragma once 
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#ifdef OOF_HEADLESS_GL
+// the Linux benchmarks render through EGL without SDL
+#include <GL/gl.h>
+#include <GL/glext.h>
+#else
+#include <SDL_opengl.h>
+#endif
+
+GLuint LoadTexture(const char *filePath);
@@ -1,58 +1,22 @@
-#ifdef _WINDOWS
-#include <GL/glew.h>
-#endif
-
-#ifdef _WINDOWS
-#define RESOURCE_FOLDER ""
-#else
-#define RESOURCE_FOLDER "NYUCodebase.app/Contents/Resources/"
-#endif
-
-#define STB_IMAGE_IMPLEMENTATION
-
 #include "helper.h"
-#include "stb_image.h"
-#include <SDL.h>
-#include <SDL_opengl.h>
-#include <SDL_image.h>
-#include <iostream> 
 #include <vector> 
 
 bool done = false;
 float lastFrameTicks = 0.0f;
 float accumulator = 0.0f;
-float animationElapsed = 0.0f;
 float framesPerSecond = 15.0f;
 std::vector<int> solidTiles = { 0, 1, 2, 5, 6, 16, 17, 18, 19, 32, 33, 34, 35, 100, 101, };
 std::vector<int> dangerTiles = { 100, 101 };
 std::vector<int> climbTile = { 6 };
+std::vector<int> wallJumpTiles = { 6 };
 
-float lerp(float v0, float v1, float t) {
-	return (1.0f - t)*v0 + t * v1;
+bool WorldRect::Overlaps(float x, float y, float width, float height) const {
+	return x + width * 0.5f >= left && x - width * 0.5f <= right &&
+		y + height * 0.5f >= bottom && y - height * 0.5f <= top;
 }
 
-GLuint LoadTexture(const char *filePath) {
-	int w, h, comp;
-	unsigned char* image = stbi_load(filePath, &w, &h, &comp, STBI_rgb_alpha);
-
-	if (image == NULL) {
-		std::cout << "Unable to load image. Make sure the path is correct\n";
-
-	}
-
-	GLuint retTexture;
-	glGenTextures(1, &retTexture);
-	glBindTexture(GL_TEXTURE_2D, retTexture);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
-
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-
-	stbi_image_free(image);
-	return retTexture;
+float lerp(float v0, float v1, float t) {
+	return (1.0f - t)*v0 + t * v1;
 }
 
 void worldToTileCoordinates(float worldX, float worldY, int *gridX, int *gridY) {
@@ -1,29 +1,35 @@
 #pragma once 
-#ifdef _WINDOWS
-#include <GL/glew.h>
-#endif
-#include <SDL.h>
-#include <SDL_opengl.h>
 #include <vector>
 
 #define FIXED_TIMESTEP 0.0166666f
 #define MAX_TIMESTEPS 6
 #define TILE_SIZE 0.1f
+// half the size of what the camera sees, matches the ortho projection
+#define VIEW_HALF_WIDTH 1.777f
+#define VIEW_HALF_HEIGHT 1.0f
 
 extern bool done; 
 extern float lastFrameTicks;
 extern float accumulator;
-extern float animationElapsed;
 extern float framesPerSecond;
 extern std::vector<int> solidTiles;
 extern std::vector<int> dangerTiles;
 extern std::vector<int> climbTile;
+extern std::vector<int> wallJumpTiles;
+enum TileFlag { TILE_SOLID = 1, TILE_DANGER = 2, TILE_CLIMB = 4, TILE_WALL_JUMP = 8 };
 enum GameMode { STATE_MAIN_MENU, STATE_GAME_LEVEL1, STATE_GAME_LEVEL2, STATE_GAME_LEVEL3, STATE_GAME_OVER, STATE_WIN };
 
+// an axis aligned rectangle in world space, e.g. what the camera can see
+struct WorldRect {
+	float left;
+	float right;
+	float bottom;
+	float top;
 
-float lerp(float v0, float v1, float t);
+	// does a box centred on (x, y) touch the rectangle
+	bool Overlaps(float x, float y, float width, float height) const;
+};
 
-GLuint LoadTexture(const char *filePath);
+float lerp(float v0, float v1, float t);
 
 void worldToTileCoordinates(float worldX, float worldY, int *gridX, int *gridY);
-
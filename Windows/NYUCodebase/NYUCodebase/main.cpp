@@ -20,7 +20,9 @@
 #include "SpriteSheet.h"
 #include "Hitbox.h"
 #include "Entity.h"
+#include "Simulation.h"
 #include "GameState.h"
+#include "RenderState.h"
 #include "helper.h"
 
 #include "glm/mat4x4.hpp"
@@ -33,6 +35,7 @@
 #include <fstream>
 #include <sstream>
 #include <cassert>
+#include <cstdlib>
 #include <string>
 #include <math.h>
 
@@ -45,8 +48,29 @@ int main(int argc, char *argv[])
 {
 	SDL_Init(SDL_INIT_VIDEO);
 	displayWindow = SDL_CreateWindow("Drink milk is good for you", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 1280, 720, SDL_WINDOW_OPENGL);
+	// vertex array objects are core from GL 3.0; no profile is asked for, the
+	// shaders still use the old attribute and varying syntax
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 0);
 	SDL_GLContext context = SDL_GL_CreateContext(displayWindow);
+	bool vertexArrays = context != NULL;
+	if (context == NULL) {
+		// an older context can still have them through ARB_vertex_array_object
+		SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 2);
+		SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 1);
+		context = SDL_GL_CreateContext(displayWindow);
+	}
+	if (context == NULL) {
+		std::cout << "unable to create an OpenGL context: " << SDL_GetError() << std::endl;
+		SDL_Quit();
+		return 1;
+	}
 	SDL_GL_MakeCurrent(displayWindow, context);
+	if (!vertexArrays && !SDL_GL_ExtensionSupported("GL_ARB_vertex_array_object")) {
+		std::cout << "OpenGL 3.0 or ARB_vertex_array_object is needed" << std::endl;
+		SDL_Quit();
+		return 1;
+	}
 
 #ifdef _WINDOWS
 	glewInit();
@@ -61,13 +85,16 @@ int main(int argc, char *argv[])
 	glm::mat4 modelMatrix = glm::mat4(1.0f);
 	glm::mat4 viewMatrix = glm::mat4(1.0f);
 
-	projectionMatrix = glm::ortho(-1.777f, 1.777f, -1.0f, 1.0f, -1.0f, 1.0f);
+	projectionMatrix = glm::ortho(-VIEW_HALF_WIDTH, VIEW_HALF_WIDTH, -VIEW_HALF_HEIGHT, VIEW_HALF_HEIGHT, -1.0f, 1.0f);
 	program.SetProjectionMatrix(projectionMatrix);
 
-	glUseProgram(program.programID);
+	renderState.UseProgram(program.programID);
 
 	GameState game = GameState(program);
-	game.Load();
+	if (!game.Load()) {
+		SDL_Quit();
+		return 1;
+	}
 	game.backgroundMusic();
 
 	SDL_Event event;
@@ -86,12 +113,29 @@ int main(int argc, char *argv[])
 		}
 
 		game.ProcessInput(keys);
-		game.Render();
-		game.Update(elapsed);
+
+		// run the simulation in fixed steps, capped so a long hitch can't spiral
+		accumulator += elapsed;
+		int steps = 0;
+		while (accumulator >= FIXED_TIMESTEP && steps < MAX_TIMESTEPS) {
+			game.Update();
+			accumulator -= FIXED_TIMESTEP;
+			steps++;
+		}
+		if (accumulator >= FIXED_TIMESTEP) {
+			accumulator = fmod(accumulator, FIXED_TIMESTEP);
+		}
+
+		game.Render(accumulator / FIXED_TIMESTEP);
 
 		SDL_GL_SwapWindow(displayWindow);
 	}
 
+	// OOF_RENDER_STATS=1 reports how many GL state changes the cache skipped
+	const char* renderStats = getenv("OOF_RENDER_STATS");
+	if (renderStats != NULL && renderStats[0] != '\0' && renderStats[0] != '0') {
+		std::cout << "render state: " << renderState.Report() << std::endl;
+	}
 	SDL_Quit();
 	return 0;
 }
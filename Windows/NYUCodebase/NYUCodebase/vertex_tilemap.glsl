@@ -0,0 +1,17 @@
+#version 130
+attribute vec4 position;
+attribute vec2 texCoord;
+
+uniform mat4 modelMatrix;
+uniform mat4 viewMatrix;
+uniform mat4 projectionMatrix;
+
+// texCoord carries the position in tiles, rows counting down
+varying vec2 texCoordVar;
+
+void main()
+{
+	vec4 p = viewMatrix * modelMatrix  * position;
+    texCoordVar = texCoord;
+	gl_Position = projectionMatrix * p;
+}